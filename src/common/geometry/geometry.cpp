@@ -2,3 +2,7 @@
 
 Geometry::~Geometry() {
 }
+
+std::shared_ptr<const TriangleMesh> Geometry::sharedMesh() const {
+    return std::make_shared<const TriangleMesh>(mesh());
+}
@@ -3,6 +3,8 @@
 /// @brief Base geometry class. All geometry subtypes support conversion to a
 /// mesh.
 
+#include <memory>
+
 #include "triangle_mesh.hpp"
 
 class Geometry {
@@ -12,6 +14,10 @@ public:
 
     /// @brief Builds a triangle mesh corresponding to the geometry.
     virtual TriangleMesh mesh() const = 0;
+
+    /// @brief Retrieves the triangle mesh as shared immutable data. Geometry
+    /// that stores a mesh shares it, and other geometry builds a new one.
+    virtual std::shared_ptr<const TriangleMesh> sharedMesh() const;
 };
 
 using GeometryPtr = std::unique_ptr<Geometry>;
@@ -1,11 +1,23 @@
 #include "geometry/mesh.hpp"
 
-Mesh::Mesh() : mMesh() {
+Mesh::Mesh() : mMesh(std::make_shared<const TriangleMesh>()) {
 }
 
-Mesh::Mesh(const TriangleMesh& mesh) : mMesh(mesh) {
+Mesh::Mesh(const TriangleMesh& mesh)
+    : mMesh(std::make_shared<const TriangleMesh>(mesh)) {
+}
+
+Mesh::Mesh(TriangleMesh&& mesh)
+    : mMesh(std::make_shared<const TriangleMesh>(std::move(mesh))) {
+}
+
+Mesh::Mesh(std::shared_ptr<const TriangleMesh> mesh) : mMesh(std::move(mesh)) {
 }
 
 TriangleMesh Mesh::mesh() const {
+    return *mMesh;
+}
+
+std::shared_ptr<const TriangleMesh> Mesh::sharedMesh() const {
     return mMesh;
 }
@@ -5,15 +5,20 @@
 #include "math/point.hpp"
 #include "prelude.hpp"
 
-/// @brief Mesh geometry.
+/// @brief Mesh geometry. The mesh is immutable and may be shared with other
+/// geometry and primitives.
 class Mesh : public Geometry {
 public:
     Mesh();
     Mesh(const TriangleMesh& mesh);
+    Mesh(TriangleMesh&& mesh);
+    Mesh(std::shared_ptr<const TriangleMesh> mesh);
     ~Mesh() override = default;
 
     TriangleMesh mesh() const override;
 
+    std::shared_ptr<const TriangleMesh> sharedMesh() const override;
+
 private:
-    TriangleMesh mMesh;
+    std::shared_ptr<const TriangleMesh> mMesh;
 };
@@ -0,0 +1,651 @@
+#include "geometry/obj_mesh_reader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/mapped_file.hpp"
+
+namespace {
+
+using View = std::string_view;
+
+/// @brief Statements that are valid but do not contribute to a triangle mesh.
+constexpr std::array<View, 30> cSkippedKeywords = {
+    // Vertex data.
+    "vp",
+    // Free-form curve or surface.
+    "deg", "bmat", "step", "cstype",
+    // Elements.
+    "p", "l", "curv", "curv2", "surf",
+    // Free-form curve or surface body statements.
+    "parm", "trim", "hole", "scrv", "sp", "end",
+    // Connectivity between free-form surfaces.
+    "con",
+    // Grouping.
+    "g", "s", "mg",
+    // Display and render attributes.
+    "bevel", "c_interp", "d_interp", "lod", "usemtl", "mtllib", "shadow_obj",
+    "trace_obj", "ctech", "stech",
+};
+
+/// @brief Cursor over the text of an .obj file. Tracks the line number for
+/// error messages.
+class Cursor {
+public:
+    Cursor(View text, const Size line)
+        : mBegin(text.data()),
+          mPos(text.data()),
+          mEnd(text.data() + text.size()),
+          mLine(line) {
+    }
+
+    bool done() const {
+        return mPos == mEnd;
+    }
+
+    /// @brief Retrieves the offset of the cursor from the start of the text.
+    Size offset() const {
+        return static_cast<Size>(mPos - mBegin);
+    }
+
+    /// @brief Retrieves the current line number.
+    Size line() const {
+        return mLine;
+    }
+
+    char peek() const {
+        return *mPos;
+    }
+
+    /// @brief Skips blanks within the line, including escaped newlines.
+    void skipBlanks() {
+        while (mPos != mEnd) {
+            const char c = *mPos;
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+                ++mPos;
+            } else if (c == '\\' && mPos + 1 != mEnd && mPos[1] == '\n') {
+                mPos += 2;
+                ++mLine;
+            } else {
+                break;
+            }
+        }
+    }
+
+    /// @brief Skips the rest of the line, including the newline.
+    void skipLine() {
+        while (mPos != mEnd) {
+            const char c = *mPos++;
+            if (c == '\\' && mPos != mEnd && *mPos == '\n') {
+                ++mPos;
+                ++mLine;
+            } else if (c == '\n') {
+                ++mLine;
+                return;
+            }
+        }
+    }
+
+    /// @brief Takes the characters up to the next blank or newline.
+    View token() {
+        skipBlanks();
+        const char* start = mPos;
+        while (mPos != mEnd && !isBreak(*mPos))
+            ++mPos;
+        return View(start, static_cast<Size>(mPos - start));
+    }
+
+    /// @brief Takes the next face corner, which ends at a blank, a newline or
+    /// a comment. This is the only tokenizer for face corners: count() and
+    /// parseChunk() both split faces with it and hasToken(), so that the
+    /// triangles they count and parse always agree.
+    View corner() {
+        skipBlanks();
+        const char* start = mPos;
+        while (mPos != mEnd && !isBreak(*mPos) && *mPos != '#')
+            ++mPos;
+        return View(start, static_cast<Size>(mPos - start));
+    }
+
+    /// @brief Determines whether the line has another token.
+    bool hasToken() {
+        skipBlanks();
+        return mPos != mEnd && *mPos != '\n' && *mPos != '#';
+    }
+
+    /// @brief Parses a floating point number token.
+    f64 number() {
+        View text = token();
+        if (!text.empty() && text.front() == '+')
+            text.remove_prefix(1);
+
+        f64 value = 0.0;
+
+#if defined(__cpp_lib_to_chars)
+        const char* end = text.data() + text.size();
+        const std::from_chars_result result =
+            std::from_chars(text.data(), end, value);
+        if (text.empty() || result.ec != std::errc() || result.ptr != end)
+            fail("expected a number");
+#else
+        // strtod needs a terminated string, and the mapping is not
+        // terminated, so the token is copied to the stack.
+        char buffer[64];
+        if (text.empty() || text.size() >= sizeof(buffer))
+            fail("expected a number");
+
+        std::memcpy(buffer, text.data(), text.size());
+        buffer[text.size()] = '\0';
+
+        char* end = nullptr;
+        value = std::strtod(buffer, &end);
+        if (end != buffer + text.size())
+            fail("expected a number");
+#endif
+
+        return value;
+    }
+
+    /// @brief Parses a signed integer index up to the next '/' or break.
+    i64 index() {
+        bool negative = false;
+        if (mPos != mEnd && (*mPos == '-' || *mPos == '+'))
+            negative = (*mPos++ == '-');
+
+        if (mPos == mEnd || *mPos < '0' || *mPos > '9')
+            fail("expected an index");
+
+        i64 value = 0;
+        while (mPos != mEnd && *mPos >= '0' && *mPos <= '9') {
+            const i64 digit = *mPos++ - '0';
+            if (value > (std::numeric_limits<i64>::max() - digit) / 10)
+                fail("index out of range");
+            value = 10 * value + digit;
+        }
+
+        return negative ? -value : value;
+    }
+
+    /// @brief Consumes the character if it is next.
+    bool accept(const char c) {
+        if (mPos != mEnd && *mPos == c) {
+            ++mPos;
+            return true;
+        }
+        return false;
+    }
+
+    [[noreturn]] void fail(const char* message) const {
+        throw std::runtime_error(
+            "obj line " + std::to_string(mLine) + ": " + message
+        );
+    }
+
+private:
+    static bool isBreak(const char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v' ||
+               c == '\n';
+    }
+
+    const char* mBegin;
+    const char* mPos;
+    const char* mEnd;
+    Size mLine;
+};
+
+/// @brief Kind of an .obj statement.
+enum class Statement {
+    Vertex,
+    Texture,
+    Normal,
+    Face,
+    Object,
+    Skipped,
+};
+
+/// @brief Classifies a statement by its keyword without allocating.
+Statement classify(const Cursor& cursor, const View keyword) {
+    if (keyword == "v")
+        return Statement::Vertex;
+    if (keyword == "vt")
+        return Statement::Texture;
+    if (keyword == "vn")
+        return Statement::Normal;
+    if (keyword == "f")
+        return Statement::Face;
+    if (keyword == "o")
+        return Statement::Object;
+
+    const auto it = std::find(
+        std::begin(cSkippedKeywords), std::end(cSkippedKeywords), keyword
+    );
+    if (it == std::end(cSkippedKeywords))
+        cursor.fail("invalid keyword");
+
+    return Statement::Skipped;
+}
+
+/// @brief Smallest chunk worth parsing on its own thread.
+constexpr Size cMinChunkSize = 1 << 20;
+
+/// @brief Marks a missing attribute in an Assignment.
+constexpr Index cNone = ~Index(0);
+
+/// @brief Attributes that a face corner assigns to a vertex.
+struct Assignment {
+    Index vertex;
+    Index texture;
+    Index normal;
+};
+
+/// @brief Range of the text parsed by one thread, and what it contains.
+struct Chunk {
+    View text;
+
+    // Line number of the first line in the chunk.
+    Size firstLine = 1;
+
+    // Number of lines and of each record in the chunk.
+    Size lines = 0;
+    Size vertices = 0;
+    Size texture = 0;
+    Size normals = 0;
+    Size triangles = 0;
+
+    // Offsets of the first two object statements, and whether any record
+    // precedes the first one.
+    Option<Size> firstObject = std::nullopt;
+    Option<Size> secondObject = std::nullopt;
+    bool recordsBeforeObject = false;
+
+    // Offsets of the chunk records in the mesh arrays.
+    Size vertexOffset = 0;
+    Size textureOffset = 0;
+    Size normalOffset = 0;
+    Size triangleOffset = 0;
+
+    // Vertex attributes in file order. Applied after all chunks are parsed,
+    // so that vertices shared between chunks are assigned deterministically.
+    // The first chunk precedes all others and applies its attributes
+    // directly instead.
+    bool deferAssignments = false;
+    std::vector<Assignment> assignments;
+
+    std::exception_ptr error;
+};
+
+/// @brief Splits the text into chunks of about `target` bytes that end after
+/// an unescaped newline.
+std::vector<Chunk> split(const View text, const Size target) {
+    std::vector<Chunk> chunks;
+
+    Size begin = 0;
+    while (begin < text.size()) {
+        Size end = std::min(begin + target, text.size());
+        while (end < text.size() &&
+               (text[end - 1] != '\n' || (end >= 2 && text[end - 2] == '\\')))
+            ++end;
+
+        Chunk chunk;
+        chunk.text = text.substr(begin, end - begin);
+        chunks.push_back(std::move(chunk));
+        begin = end;
+    }
+
+    return chunks;
+}
+
+/// @brief Runs `work(chunk)` for every chunk on up to `thread_count` threads.
+/// An error stops the work on its chunk and is stored in the chunk.
+template <typename Work>
+void forEachChunk(
+    std::vector<Chunk>& chunks, const Size thread_count, Work&& work
+) {
+    std::atomic<Index> next(0);
+
+    auto run = [&]() {
+        for (Index i = next++; i < chunks.size(); i = next++) {
+            try {
+                work(chunks[i]);
+            } catch (...) {
+                chunks[i].error = std::current_exception();
+            }
+        }
+    };
+
+    const Size count = std::min(thread_count, chunks.size());
+    if (count <= 1) {
+        run();
+    } else {
+        std::vector<std::thread> threads;
+        for (Index i = 0; i < count; ++i)
+            threads.emplace_back(run);
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+}
+
+/// @brief Rethrows the error of the first chunk that failed, which is the
+/// first error in the file.
+void rethrowFirstError(const std::vector<Chunk>& chunks) {
+    for (const Chunk& chunk : chunks)
+        if (chunk.error)
+            std::rethrow_exception(chunk.error);
+}
+
+/// @brief Counts the records of a chunk and locates its object statements.
+void count(Chunk& chunk) {
+    Cursor cursor(chunk.text, chunk.firstLine);
+
+    while (!cursor.done()) {
+        cursor.skipBlanks();
+        if (cursor.done())
+            break;
+
+        if (cursor.peek() == '\n' || cursor.peek() == '#') {
+            cursor.skipLine();
+            continue;
+        }
+
+        const Size offset = cursor.offset();
+        const Statement statement = classify(cursor, cursor.token());
+
+        switch (statement) {
+        case Statement::Vertex:
+            ++chunk.vertices;
+            break;
+        case Statement::Texture:
+            ++chunk.texture;
+            break;
+        case Statement::Normal:
+            ++chunk.normals;
+            break;
+        case Statement::Face: {
+            Size corners = 0;
+            while (cursor.hasToken()) {
+                cursor.corner();
+                ++corners;
+            }
+            chunk.triangles += (corners > 2) ? corners - 2 : 0;
+            break;
+        }
+        case Statement::Object:
+            if (!chunk.firstObject)
+                chunk.firstObject = offset;
+            else if (!chunk.secondObject)
+                chunk.secondObject = offset;
+            break;
+        case Statement::Skipped:
+            break;
+        }
+
+        if (statement != Statement::Object && statement != Statement::Skipped &&
+            !chunk.firstObject)
+            chunk.recordsBeforeObject = true;
+
+        cursor.skipLine();
+    }
+
+    chunk.lines = cursor.line() - chunk.firstLine;
+}
+
+/// @brief Restricts the chunks to the first object. Everything from the
+/// first object statement that follows a record or another object statement
+/// onwards is dropped, including any errors. Also numbers the first line of
+/// every chunk.
+/// @throws std::runtime_error if a chunk before the cut failed to count.
+void truncateToFirstObject(std::vector<Chunk>& chunks) {
+    bool started = false;
+    Size line = 1;
+
+    for (Index i = 0; i < chunks.size(); ++i) {
+        Chunk& chunk = chunks[i];
+        chunk.firstLine = line;
+
+        Option<Size> cut = std::nullopt;
+        if (chunk.firstObject && (started || chunk.recordsBeforeObject))
+            cut = chunk.firstObject;
+        else if (chunk.secondObject)
+            cut = chunk.secondObject;
+
+        if (cut) {
+            Chunk truncated;
+            truncated.text = chunk.text.substr(0, *cut);
+            truncated.firstLine = line;
+            count(truncated);
+            chunk = std::move(truncated);
+            chunks.resize(i + 1);
+            return;
+        }
+
+        // Objects are located before counting fails, so an error is only
+        // reached if it precedes any cut. The chunk was counted before its
+        // first line was known, so it is counted again to report the error
+        // at the right line.
+        if (chunk.error) {
+            Chunk failed;
+            failed.text = chunk.text;
+            failed.firstLine = line;
+            count(failed);
+            std::rethrow_exception(chunk.error);
+        }
+
+        line += chunk.lines;
+
+        started = started || chunk.firstObject || chunk.vertices > 0 ||
+                  chunk.texture > 0 || chunk.normals > 0 || chunk.triangles > 0;
+    }
+}
+
+/// @brief Converts a 1-based or negative relative .obj index to a 0-based
+/// index into an array that currently holds `count` elements.
+Index resolve(const Cursor& cursor, const i64 index, const Size count) {
+    const i64 resolved =
+        (index > 0) ? index - 1 : static_cast<i64>(count) + index;
+    if (index == 0 || resolved < 0 || static_cast<Size>(resolved) >= count)
+        cursor.fail("index out of range");
+    return static_cast<Index>(resolved);
+}
+
+/// @brief Mesh arrays sized for the whole object. Chunks write disjoint
+/// ranges of them.
+struct MeshArrays {
+    std::vector<Vertex> vertices;
+    std::vector<Point2D> texture;
+    std::vector<Normal3D> normals;
+    std::vector<TriangleMesh::Tri> triangles;
+};
+
+/// @brief Assigns the corner attributes to the vertex.
+void assign(MeshArrays& mesh, const Assignment& assignment) {
+    Vertex& vertex = mesh.vertices[assignment.vertex];
+    if (assignment.texture != cNone)
+        vertex.uv = mesh.texture[assignment.texture];
+    if (assignment.normal != cNone)
+        vertex.n = mesh.normals[assignment.normal];
+}
+
+/// @brief Parses the records of a chunk into its ranges of the mesh arrays.
+/// The offsets of the chunk are the numbers of elements read before it, so
+/// indices resolve exactly as in a sequential read.
+void parseChunk(Chunk& chunk, MeshArrays& mesh) {
+    Index v = chunk.vertexOffset;
+    Index vt = chunk.textureOffset;
+    Index vn = chunk.normalOffset;
+    Index t = chunk.triangleOffset;
+    const Index triangles_end = chunk.triangleOffset + chunk.triangles;
+
+    Cursor cursor(chunk.text, chunk.firstLine);
+
+    // Resolves a face corner to a vertex and records the corner attributes.
+    // The corner token must be consumed entirely.
+    auto corner = [&]() {
+        Cursor text(cursor.corner(), cursor.line());
+        Assignment assignment{resolve(text, text.index(), v), cNone, cNone};
+
+        if (text.accept('/')) {
+            if (!text.accept('/')) {
+                assignment.texture = resolve(text, text.index(), vt);
+                if (text.accept('/'))
+                    assignment.normal = resolve(text, text.index(), vn);
+            } else {
+                assignment.normal = resolve(text, text.index(), vn);
+            }
+        }
+
+        if (!text.done())
+            text.fail("unexpected characters after face corner");
+
+        if (!chunk.deferAssignments)
+            assign(mesh, assignment);
+        else if (assignment.texture != cNone || assignment.normal != cNone)
+            chunk.assignments.push_back(assignment);
+
+        return assignment.vertex;
+    };
+
+    while (!cursor.done()) {
+        cursor.skipBlanks();
+        if (cursor.done())
+            break;
+
+        if (cursor.peek() == '\n' || cursor.peek() == '#') {
+            cursor.skipLine();
+            continue;
+        }
+
+        switch (classify(cursor, cursor.token())) {
+        case Statement::Vertex: {
+            const f64 x = cursor.number();
+            const f64 y = cursor.number();
+            const f64 z = cursor.number();
+            const f64 w = cursor.hasToken() ? cursor.number() : 1.0;
+            mesh.vertices[v++].p = Point3D(x / w, y / w, z / w);
+            break;
+        }
+        case Statement::Texture: {
+            const f64 x = cursor.number();
+            const f64 y = cursor.hasToken() ? cursor.number() : 0.0;
+            if (cursor.hasToken())
+                cursor.number();
+            mesh.texture[vt++] = Point2D(x, y);
+            break;
+        }
+        case Statement::Normal: {
+            const f64 x = cursor.number();
+            const f64 y = cursor.number();
+            const f64 z = cursor.number();
+            mesh.normals[vn++] = Normal3D(x, y, z);
+            break;
+        }
+        case Statement::Face: {
+            cursor.skipBlanks();
+            const Index first = corner();
+            if (!cursor.hasToken())
+                cursor.fail("face must have at least 3 vertices");
+            Index previous = corner();
+            if (!cursor.hasToken())
+                cursor.fail("face must have at least 3 vertices");
+
+            while (cursor.hasToken()) {
+                const Index current = corner();
+                assertm(
+                    t < triangles_end, "t must be within the counted triangles"
+                );
+                mesh.triangles[t++] = {first, previous, current};
+                previous = current;
+            }
+            break;
+        }
+        case Statement::Object:
+        case Statement::Skipped:
+            break;
+        }
+
+        cursor.skipLine();
+    }
+}
+
+}
+
+ObjMeshReader::ObjMeshReader(const Size threads) : mThreads(threads) {
+}
+
+TriangleMesh ObjMeshReader::read(const char* path) const {
+    const MappedFile file(path);
+    const View text(
+        reinterpret_cast<const char*>(file.bytes().data()), file.size()
+    );
+    return parse(text);
+}
+
+TriangleMesh ObjMeshReader::parse(View text) const {
+    const Size thread_count =
+        (mThreads > 0)
+            ? mThreads
+            : std::max<Size>(std::thread::hardware_concurrency(), 1);
+
+    // Several chunks per thread balance the load when the records are
+    // unevenly distributed, such as vertices first and faces last.
+    const Size target =
+        (thread_count > 1)
+            ? std::max(cMinChunkSize, text.size() / (4 * thread_count) + 1)
+            : text.size();
+    std::vector<Chunk> chunks = split(text, target);
+
+    // First pass: count the records of every chunk.
+    forEachChunk(chunks, thread_count, count);
+
+    truncateToFirstObject(chunks);
+
+    // Prefix sums place the records of every chunk in the mesh arrays.
+    MeshArrays mesh;
+    Size vertices = 0;
+    Size texture = 0;
+    Size normals = 0;
+    Size triangles = 0;
+
+    for (Chunk& chunk : chunks) {
+        chunk.deferAssignments = (&chunk != &chunks.front());
+        chunk.vertexOffset = vertices;
+        chunk.textureOffset = texture;
+        chunk.normalOffset = normals;
+        chunk.triangleOffset = triangles;
+
+        vertices += chunk.vertices;
+        texture += chunk.texture;
+        normals += chunk.normals;
+        triangles += chunk.triangles;
+    }
+
+    mesh.vertices.resize(vertices);
+    mesh.texture.resize(texture);
+    mesh.normals.resize(normals);
+    mesh.triangles.resize(triangles);
+
+    // Second pass: parse every chunk into its ranges of the arrays.
+    forEachChunk(chunks, thread_count, [&](Chunk& chunk) {
+        parseChunk(chunk, mesh);
+    });
+    rethrowFirstError(chunks);
+
+    // Apply the corner attributes in file order, so that the last corner
+    // that specifies an attribute wins regardless of the chunking.
+    for (Chunk& chunk : chunks) {
+        for (const Assignment& assignment : chunk.assignments)
+            assign(mesh, assignment);
+        chunk.assignments = {};
+    }
+
+    return TriangleMesh(std::move(mesh.vertices), std::move(mesh.triangles));
+}
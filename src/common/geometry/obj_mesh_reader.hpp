@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string_view>
+
+#include "geometry/triangle_mesh.hpp"
+#include "prelude.hpp"
+
+/// @brief Wavefront .obj reader that builds a TriangleMesh directly. Files
+/// are memory-mapped and tokenized in place, so the text is never copied, and
+/// vertices and triangles are written to the flat mesh arrays as they are
+/// read instead of going through ObjData.
+///
+/// Like `TriangleMesh(const ObjObject&)`, only the first object of the file
+/// is read, vertices correspond to positions, and each vertex takes the
+/// normal and texture coordinates of the last face corner that specifies
+/// them. Polygons are triangulated as fans, and negative indices are relative
+/// to the elements read so far. Statements that do not contribute
+/// to a triangle mesh, such as groups, materials and free-form geometry, are
+/// skipped.
+///
+/// Large files are split into chunks at line boundaries and parsed in two
+/// parallel passes. The first pass counts the records of every chunk, and
+/// the prefix sums of the counts place each chunk in the mesh arrays and
+/// tell it how many elements precede it, so that relative indices resolve as
+/// in a sequential read. The second pass parses the chunks into place.
+class ObjMeshReader {
+public:
+    /// @brief Creates a reader that parses on up to `threads` threads, or on
+    /// one thread per hardware thread if `threads` is zero.
+    explicit ObjMeshReader(const Size threads = 0);
+    ~ObjMeshReader() = default;
+
+    /// @brief Reads the mesh from the .obj file at the path.
+    /// @throws std::runtime_error if the file cannot be read or is malformed.
+    TriangleMesh read(const char* path) const;
+
+    /// @brief Reads the mesh from .obj text.
+    /// @throws std::runtime_error if the text is malformed.
+    TriangleMesh parse(std::string_view text) const;
+
+private:
+    Size mThreads;
+};
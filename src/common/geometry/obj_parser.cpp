@@ -1,10 +1,14 @@
 #include "geometry/obj_parser.hpp"
 
+#include <charconv>
+#include <cstdlib>
 #include <map>
+#include <type_traits>
 
 #include "common/prelude.hpp"
 #include "util/format.hpp"
 #include "util/log.hpp"
+#include "util/swar.hpp"
 
 constexpr const char* cWhitespaceAll = " \f\n\r\t\v";
 constexpr const char* cWhitespaceNoNewline = " \f\r\t\v";
@@ -63,7 +67,9 @@ enum class Keyword {
     SurfaceApproximationTechnique,  // TODO:
 };
 
-std::map<std::string, Keyword> keywordStrings = {
+// Transparent comparison lets keywords be looked up by view, without
+// allocating a string for every statement.
+const std::map<std::string, Keyword, std::less<>> keywordStrings = {
     // Vertex data.
     {"v", Keyword::VertexGeometric},
     {"vt", Keyword::VertexTexture},
@@ -114,6 +120,50 @@ std::map<std::string, Keyword> keywordStrings = {
     {"stech", Keyword::SurfaceApproximationTechnique},
 };
 
+/// @brief Determines whether the character is whitespace other than a
+/// newline.
+bool isBlank(const char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/// @brief Parses a number from the beginning of the view with
+/// std::from_chars, which needs neither a terminated string nor the locale.
+/// A leading '+' is accepted, as by strtod and strtoll.
+template <typename T>
+Option<ParseResult<T>> fromChars(const View view) {
+    const char* start = view.data();
+    const char* end = start + view.size();
+    const char* first = (start != end && *start == '+') ? start + 1 : start;
+
+#if defined(__cpp_lib_to_chars)
+    constexpr bool supported = true;
+#else
+    // Floating point std::from_chars is missing from some standard libraries.
+    constexpr bool supported = std::is_integral_v<T>;
+#endif
+
+    T value{};
+    const char* last = first;
+
+    if constexpr (supported) {
+        const std::from_chars_result result =
+            std::from_chars(first, end, value);
+        if (result.ec != std::errc())
+            return std::nullopt;
+        last = result.ptr;
+    } else {
+        // strtod relies on the view being terminated, which holds as the
+        // views point into the std::string being parsed.
+        char* parsed = nullptr;
+        value = std::strtod(first, &parsed);
+        if (parsed == first)
+            return std::nullopt;
+        last = parsed;
+    }
+
+    return ParseResult<T>{value, view.substr(last - start)};
+}
+
 }
 
 using namespace obj;
@@ -286,6 +336,7 @@ ParseResult<Polyline> ObjParser::parsePolyline(View view) const {
 
 ParseResult<Face> ObjParser::parseFace(View view) const {
     Face face;
+    face.vertices.reserve(4);
     while (const Option<ParseResult<FaceVertex>> v = tryParseFaceVertex(view)) {
         face.vertices.push_back(v->value);
         view = v->rest;
@@ -339,84 +390,51 @@ ParseResult<View> ObjParser::parseObjectName(View view) const {
 }
 
 ParseResult<Keyword> ObjParser::parseKeyword(View view) const {
+    // Fast path for the statements that make up nearly all of a mesh, which
+    // skips the tokenization and the map lookup.
+    if (view.size() >= 2 && view[0] == 'f' && isBlank(view[1]))
+        return {Keyword::Face, view.substr(1)};
+
+    if (view.size() >= 2 && view[0] == 'v' && isBlank(view[1]))
+        return {Keyword::VertexGeometric, view.substr(1)};
+
+    if (view.size() >= 3 && view[0] == 'v' && isBlank(view[2])) {
+        if (view[1] == 'n')
+            return {Keyword::VertexNormal, view.substr(2)};
+        if (view[1] == 't')
+            return {Keyword::VertexTexture, view.substr(2)};
+    }
+
     const ParseResult<View> result = takeNonwhitespace(view);
-    const std::string key(result.value);
+    const View key = result.value;
 
-    if (keywordStrings.find(key) != keywordStrings.end()) {
-        return {keywordStrings[key], result.rest};
+    if (const auto it = keywordStrings.find(key); it != keywordStrings.end()) {
+        return {it->second, result.rest};
     } else {
         throw std::runtime_error(format("invalid keyword: {}", key));
     }
 }
 
 ParseResult<f64> ObjParser::parseFloat(View view) const {
-    view = skipWhitespace(view);
-
-    const char* start = view.data();
-    char* end = nullptr;
-
-    const f64 value = std::strtod(start, &end);
-
-    if (end != start) {
-        const Index length = static_cast<Index>(end - start);
-        return {value, view.substr(length)};
-    }
+    if (const Option<ParseResult<f64>> result = tryParseFloat(view))
+        return *result;
 
     throw std::runtime_error("failed to parse float");
 }
 
 Option<ParseResult<f64>> ObjParser::tryParseFloat(View view) const {
-    if (view.empty())
-        return std::nullopt;
-
-    view = skipWhitespace(view);
-
-    const char* start = view.data();
-    char* end = nullptr;
-
-    const f64 value = std::strtod(start, &end);
-
-    if (end != start) {
-        const Index length = static_cast<Index>(end - start);
-        return Option<ParseResult<f64>>({value, view.substr(length)});
-    }
-
-    return std::nullopt;
+    return fromChars<f64>(skipWhitespace(view));
 }
 
 ParseResult<i64> ObjParser::parseIndex(View view) const {
-    view = skipWhitespace(view);
-
-    const char* start = view.data();
-    char* end = nullptr;
-
-    const i64 value = std::strtoll(start, &end, 10);
-
-    if (end != start) {
-        const Index length = static_cast<Index>(end - start);
-        return {value, view.substr(length)};
-    }
+    if (const Option<ParseResult<i64>> result = tryParseIndex(view))
+        return *result;
 
     throw std::runtime_error("failed to parse integral index");
 }
 
 Option<ParseResult<i64>> ObjParser::tryParseIndex(View view) const {
-    if (view.empty())
-        return std::nullopt;
-
-    view = skipWhitespace(view);
-
-    const char* start = view.data();
-    char* end = nullptr;
-
-    const i64 value = std::strtoll(start, &end, 10);
-
-    if (end != start) {
-        const Index length = static_cast<Index>(end - start);
-        return Option<ParseResult<i64>>({value, view.substr(length)});
-    }
-
-    return std::nullopt;
+    return fromChars<i64>(skipWhitespace(view));
 }
 
 View ObjParser::skipComment(View view) const {
@@ -427,27 +445,29 @@ View ObjParser::skipComment(View view) const {
 }
 
 View ObjParser::skipWhitespace(View view) const {
-    while (true) {
-        const Index pos = view.find_first_not_of(cWhitespaceNoNewline);
-
-        if (pos == View::npos)
-            return {};
-
-        view = view.substr(pos);
-
-        if (isEscapedNewline(view, 0)) {
-            view = view.substr(1);
-            continue;
-        }
-
-        break;
+    // Tokens are nearly always separated by a single space, so a plain loop
+    // beats a general search here.
+    Index pos = 0;
+    while (pos < view.size()) {
+        if (isBlank(view[pos]))
+            ++pos;
+        else if (isEscapedNewline(view, pos))
+            pos += 2;
+        else
+            break;
     }
 
-    return view;
+    return view.substr(pos);
 }
 
 ParseResult<View> ObjParser::takeNonwhitespace(const View view) const {
-    const Index pos = view.find_first_of(cWhitespaceAll);
+    // Every whitespace character is a space or a control character, so the
+    // word-at-a-time scan finds all candidates.
+    Index pos = swar::findSpaceOrControl(view);
+    while (pos < view.size() &&
+           std::strchr(cWhitespaceAll, view[pos]) == nullptr)
+        pos += 1 + swar::findSpaceOrControl(view.substr(pos + 1));
+
     return {view.substr(0, pos), view.substr(pos)};
 }
 
@@ -465,8 +485,9 @@ bool ObjParser::isEscapedNewline(const View view, const Index pos) const {
 }
 
 Option<Index> ObjParser::findUnescapedNewline(const View view) const {
+    // The search for a newline is memchr, which is already vectorized.
     Index pos = 0;
-    while ((pos = view.find('\n')) != View::npos) {
+    while ((pos = view.find('\n', pos)) != View::npos) {
         if (pos == 0 || view[pos - 1] != '\\')
             return pos;
         ++pos;
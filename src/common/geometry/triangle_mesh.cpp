@@ -35,6 +35,12 @@ TriangleMesh::TriangleMesh(const ObjObject& obj)
     }
 }
 
+TriangleMesh::TriangleMesh(
+    std::vector<Vertex>&& vertices, std::vector<Tri>&& triangles
+)
+    : mVertices(std::move(vertices)), mTriangles(std::move(triangles)) {
+}
+
 const std::vector<Vertex>& TriangleMesh::vertices() const {
     return mVertices;
 }
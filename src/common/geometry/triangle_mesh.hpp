@@ -16,6 +16,7 @@ public:
 
     TriangleMesh();
     explicit TriangleMesh(const ObjObject& obj);
+    TriangleMesh(std::vector<Vertex>&& vertices, std::vector<Tri>&& triangles);
     ~TriangleMesh() = default;
 
     /// @brief Retrieve a constant reference to the vertex array.
@@ -1,9 +1,23 @@
 #include "aabb.hpp"
 
-const AABB AABB::empty =
-    AABB(Interval::empty, Interval::empty, Interval::empty);
-const AABB AABB::universe =
-    AABB(Interval::universe, Interval::universe, Interval::universe);
+namespace {
+
+// The Interval constants live in another translation unit, so they may not be
+// initialized yet when the AABB constants are. Build the intervals locally.
+const f64 cInfinity = math::infinity<f64>();
+
+}
+
+const AABB AABB::empty = AABB(
+    Interval(cInfinity, -cInfinity),
+    Interval(cInfinity, -cInfinity),
+    Interval(cInfinity, -cInfinity)
+);
+const AABB AABB::universe = AABB(
+    Interval(-cInfinity, cInfinity),
+    Interval(-cInfinity, cInfinity),
+    Interval(-cInfinity, cInfinity)
+);
 
 AABB::AABB() : x(Interval::empty), y(Interval::empty), z(Interval::empty) {
 }
@@ -57,32 +71,30 @@ const Interval& AABB::axis(const Index i) const {
 }
 
 bool AABB::checkIntersect(const Ray& ray, const Interval& bounds) const {
-    Interval slab_bounds = bounds;
+    return checkIntersect(TraversalRay(ray), bounds);
+}
+
+bool AABB::checkIntersect(
+    const TraversalRay& ray, const Interval& bounds
+) const {
+    f64 t_min = bounds.min;
+    f64 t_max = bounds.max;
 
     for (Index i = 0; i < 3; ++i) {
         const Interval& ax = axis(i);
-        const f64 dir_inv = 1.0 / ray.direction[i];
-
-        const f64 t0 = (ax.min - ray.origin[i]) * dir_inv;
-        const f64 t1 = (ax.max - ray.origin[i]) * dir_inv;
-
-        if (t0 < t1) {
-            if (t0 > slab_bounds.min)
-                slab_bounds.min = t0;
-            if (t1 < slab_bounds.max)
-                slab_bounds.max = t1;
-        } else {
-            if (t1 > slab_bounds.min)
-                slab_bounds.min = t1;
-            if (t0 < slab_bounds.max)
-                slab_bounds.max = t0;
-        }
-
-        if (slab_bounds.max <= slab_bounds.min)
-            return false;
+        const f64 near = ray.dirIsNeg[i] ? ax.max : ax.min;
+        const f64 far = ray.dirIsNeg[i] ? ax.min : ax.max;
+
+        const f64 t0 = (near - ray.origin[i]) * ray.invDir[i];
+        const f64 t1 = (far - ray.origin[i]) * ray.invDir[i];
+
+        // Comparisons with NaN are false, so a NaN parameter leaves the
+        // interval unchanged. Both compile to min and max instructions.
+        t_min = t0 > t_min ? t0 : t_min;
+        t_max = t1 < t_max ? t1 : t_max;
     }
 
-    return true;
+    return t_min <= t_max;
 }
 
 AABB AABB::enclosure(const AABB& other) const {
@@ -106,6 +118,22 @@ Index AABB::longestAxis() const {
         return y.size() > z.size() ? 1 : 2;
 }
 
+Point3D AABB::centroid() const {
+    return Point3D(
+        0.5 * (x.min + x.max), 0.5 * (y.min + y.max), 0.5 * (z.min + z.max)
+    );
+}
+
+f64 AABB::surfaceArea() const {
+    if (x.size() < 0.0 || y.size() < 0.0 || z.size() < 0.0)
+        return 0.0;
+
+    const f64 dx = x.size();
+    const f64 dy = y.size();
+    const f64 dz = z.size();
+    return 2.0 * (dx * dy + dy * dz + dz * dx);
+}
+
 void AABB::padWithMinimum() {
     if (x.size() < MINIMUM_AXIS_SIZE)
         x = x.expand(MINIMUM_AXIS_SIZE);
@@ -3,6 +3,7 @@
 #include "math/interval.hpp"
 #include "math/point.hpp"
 #include "math/ray.hpp"
+#include "math/traversal_ray.hpp"
 #include "util/format.hpp"
 
 /// @brief Axis-aligned bounding box used for efficient intersection checks. The
@@ -42,6 +43,14 @@ public:
     /// @brief Checks whether the ray intersects the bounding box.
     bool checkIntersect(const Ray& ray, const Interval& bounds) const;
 
+    /// @brief Checks whether the ray intersects the bounding box within the
+    /// parameter bounds, touching included. The near and far planes are
+    /// selected by the direction signs and the slab intervals are combined
+    /// with min and max, without branches. Axis-parallel rays have infinite
+    /// slab parameters, or NaN for a ray starting on the plane, which is
+    /// ignored so that the ray counts as inside that slab.
+    bool checkIntersect(const TraversalRay& ray, const Interval& bounds) const;
+
     /// @brief Creates a new AABB that tightly encloses two AABBs.
     AABB enclosure(const AABB& other) const;
 
@@ -51,6 +60,13 @@ public:
     /// @brief Retrieves index of the longest axis.
     Index longestAxis() const;
 
+    /// @brief Retrieves the center point of the AABB.
+    Point3D centroid() const;
+
+    /// @brief Computes the surface area of the AABB. The empty AABB has zero
+    /// surface area.
+    f64 surfaceArea() const;
+
     union {
         struct {
             Interval x;
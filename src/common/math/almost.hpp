@@ -1,5 +1,6 @@
 #pragma once
 
+#include "math/numeric.hpp"
 #include "prelude.hpp"
 
 namespace almost {
@@ -6,6 +6,10 @@ const Interval Interval::universe =
     Interval(-math::infinity<f64>(), math::infinity<f64>());
 const Interval Interval::unit = Interval(0.0, 1.0);
 
+Interval::Interval()
+    : min(math::infinity<f64>()), max(-math::infinity<f64>()) {
+}
+
 Interval::Interval(const f64 min, const f64 max) : min(min), max(max) {
 }
 
@@ -7,6 +7,8 @@
 /// @brief Real number interval.
 class Interval {
 public:
+    /// @brief Constructs the empty interval.
+    Interval();
     Interval(const f64 min, const f64 max);
     ~Interval() = default;
 
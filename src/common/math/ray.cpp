@@ -1,5 +1,8 @@
 #include "math/ray.hpp"
 
+Ray::Ray() : origin(), direction() {
+}
+
 Ray::Ray(const Point3D& origin, const Vector3D& direction)
     : origin(origin), direction(direction) {
 }
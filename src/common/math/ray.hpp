@@ -7,6 +7,9 @@
 /// @brief 3D ray class.
 class Ray {
 public:
+    /// @brief Constructs a ray at the origin with a zero direction, which
+    /// fills the unused slots of fixed-size ray packets.
+    Ray();
     Ray(const Point3D& origin, const Vector3D& direction);
     ~Ray() = default;
 
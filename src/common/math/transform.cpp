@@ -163,33 +163,40 @@ const Matrix4D& Transform::inverse() const {
     return mInverse;
 }
 
+bool Transform::isIdentity() const {
+    return mMatrix == Matrix4D::ident();
+}
+
+// The transformations below only read the affine 3x4 part of the matrices.
+// The bottom row of an affine transformation is always (0, 0, 0, 1).
+
 Vector3D Transform::operator()(const Vector3D& v) const {
-    Vector3D result;
-    for (Index row = 0; row < 3; ++row)
-        for (Index col = 0; col < 3; ++col)
-            result[row] += mMatrix(row, col) * v[col];
-    return result;
+    const Matrix4D& m = mMatrix;
+    return Vector3D(
+        m(0, 0) * v.x + m(0, 1) * v.y + m(0, 2) * v.z,
+        m(1, 0) * v.x + m(1, 1) * v.y + m(1, 2) * v.z,
+        m(2, 0) * v.x + m(2, 1) * v.y + m(2, 2) * v.z
+    );
 }
 
 Normal3D Transform::operator()(const Normal3D& n) const {
-    const Matrix4D inv_transpose = transpose(mInverse);
-
-    Normal3D result;
-    for (Index row = 0; row < 3; ++row)
-        for (Index col = 0; col < 3; ++col)
-            result[row] += inv_transpose(row, col) * n[col];
-    return result;
+    // Normals transform with the inverse transpose, so index the inverse
+    // with rows and columns swapped.
+    const Matrix4D& m = mInverse;
+    return Normal3D(
+        m(0, 0) * n.x + m(1, 0) * n.y + m(2, 0) * n.z,
+        m(0, 1) * n.x + m(1, 1) * n.y + m(2, 1) * n.z,
+        m(0, 2) * n.x + m(1, 2) * n.y + m(2, 2) * n.z
+    );
 }
 
 Point3D Transform::operator()(const Point3D& p) const {
-    Point3D result;
-    for (Index row = 0; row < 3; ++row)
-        for (Index col = 0; col < 3; ++col)
-            result[row] += mMatrix(row, col) * p[col];
-    result[0] += mMatrix(0, 3);
-    result[1] += mMatrix(1, 3);
-    result[2] += mMatrix(2, 3);
-    return result;
+    const Matrix4D& m = mMatrix;
+    return Point3D(
+        m(0, 0) * p.x + m(0, 1) * p.y + m(0, 2) * p.z + m(0, 3),
+        m(1, 0) * p.x + m(1, 1) * p.y + m(1, 2) * p.z + m(1, 3),
+        m(2, 0) * p.x + m(2, 1) * p.y + m(2, 2) * p.z + m(2, 3)
+    );
 }
 
 Ray Transform::operator()(const Ray& ray) const {
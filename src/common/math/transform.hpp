@@ -54,6 +54,9 @@ public:
     /// matrix.
     const Matrix4D& inverse() const;
 
+    /// @brief Determines whether the transformation is the identity.
+    bool isIdentity() const;
+
     Vector3D operator()(const Vector3D& v) const;
     Normal3D operator()(const Normal3D& n) const;
     Point3D operator()(const Point3D& p) const;
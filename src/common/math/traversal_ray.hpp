@@ -0,0 +1,30 @@
+#pragma once
+
+#include "math/point.hpp"
+#include "math/ray.hpp"
+#include "math/vector.hpp"
+
+/// @brief Ray prepared for repeated slab tests against bounding boxes. The
+/// reciprocal direction and the direction signs are computed once per ray
+/// instead of once per box. Zero direction components have infinite
+/// reciprocals, signed like the zero.
+class TraversalRay {
+public:
+    explicit TraversalRay(const Ray& ray);
+    ~TraversalRay() = default;
+
+    Point3D origin;
+    Vector3D invDir;
+
+    // Whether each reciprocal direction component is negative, which selects
+    // the near and far plane of every slab.
+    bool dirIsNeg[3];
+};
+
+inline TraversalRay::TraversalRay(const Ray& ray)
+    : origin(ray.origin),
+      invDir(
+          1.0 / ray.direction.x, 1.0 / ray.direction.y, 1.0 / ray.direction.z
+      ),
+      dirIsNeg{invDir.x < 0.0, invDir.y < 0.0, invDir.z < 0.0} {
+}
@@ -0,0 +1,57 @@
+#include "util/binary_io.hpp"
+
+#include <filesystem>
+
+BinaryWriter::BinaryWriter()
+    : mPath(), mTemporaryPath(), mStream(), mBuffer() {
+}
+
+BinaryWriter::BinaryWriter(const std::string& path)
+    : mPath(path),
+      mTemporaryPath(path + ".tmp"),
+      mStream(mTemporaryPath, std::ios::binary | std::ios::trunc),
+      mBuffer() {
+    if (!mStream)
+        throw std::runtime_error("could not create file: " + mTemporaryPath);
+}
+
+void BinaryWriter::writeBytes(const void* data, const Size size) {
+    if (mPath.empty()) {
+        const u8* bytes = static_cast<const u8*>(data);
+        mBuffer.insert(std::end(mBuffer), bytes, bytes + size);
+        return;
+    }
+
+    mStream.write(
+        static_cast<const char*>(data), static_cast<std::streamsize>(size)
+    );
+}
+
+std::span<const u8> BinaryWriter::bytes() const {
+    return mBuffer;
+}
+
+void BinaryWriter::commit() {
+    mStream.close();
+    if (!mStream)
+        throw std::runtime_error("could not write file: " + mTemporaryPath);
+
+    std::filesystem::rename(mTemporaryPath, mPath);
+}
+
+BinaryReader::BinaryReader(std::span<const u8> bytes)
+    : mBytes(bytes), mOffset(0) {
+}
+
+void BinaryReader::readBytes(void* data, const Size size) {
+    if (size > remaining())
+        throw std::runtime_error("binary data is truncated");
+
+    if (size > 0)
+        std::memcpy(data, mBytes.data() + mOffset, size);
+    mOffset += size;
+}
+
+Size BinaryReader::remaining() const {
+    return mBytes.size() - mOffset;
+}
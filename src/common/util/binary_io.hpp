@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "prelude.hpp"
+
+/// @brief Writes trivially copyable values in native byte order, either to a
+/// buffer in memory or to a binary file. File output goes to a temporary file
+/// that replaces the destination on commit(), so readers never see a
+/// partially written file.
+class BinaryWriter {
+public:
+    /// @brief Writes to a buffer in memory, retrieved with bytes().
+    BinaryWriter();
+
+    /// @throws std::runtime_error if the file cannot be created.
+    explicit BinaryWriter(const std::string& path);
+
+    /// @brief Writes the raw bytes.
+    void writeBytes(const void* data, const Size size);
+
+    /// @brief Writes the object representation of the value.
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        writeBytes(&value, sizeof(T));
+    }
+
+    /// @brief Writes the length of the vector followed by its elements.
+    template <typename T>
+    void writeVector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write<u64>(values.size());
+        writeBytes(values.data(), values.size() * sizeof(T));
+    }
+
+    /// @brief Writes the x, y and z components of a 3D point, vector or
+    /// normal.
+    template <typename T>
+    void writeXYZ(const T& value) {
+        write<f64>(value.x);
+        write<f64>(value.y);
+        write<f64>(value.z);
+    }
+
+    /// @brief Retrieves the bytes written to the memory buffer.
+    std::span<const u8> bytes() const;
+
+    /// @brief Flushes the file and moves it to the destination path.
+    /// @throws std::runtime_error if any write failed.
+    void commit();
+
+private:
+    std::string mPath;
+    std::string mTemporaryPath;
+    std::ofstream mStream;
+
+    // Output of a writer without a file.
+    std::vector<u8> mBuffer;
+};
+
+/// @brief Reads values written by BinaryWriter from a span of bytes, such as
+/// a memory-mapped file. Every read is bounds checked.
+class BinaryReader {
+public:
+    explicit BinaryReader(std::span<const u8> bytes);
+
+    /// @brief Reads `size` raw bytes into `data`.
+    /// @throws std::runtime_error if fewer than `size` bytes remain.
+    void readBytes(void* data, const Size size);
+
+    /// @brief Reads a value.
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    /// @brief Reads a length-prefixed vector.
+    template <typename T>
+    std::vector<T> readVector() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const u64 count = read<u64>();
+        if (count > remaining() / sizeof(T))
+            throw std::runtime_error("binary data is truncated");
+
+        std::vector<T> values(count);
+        readBytes(values.data(), count * sizeof(T));
+        return values;
+    }
+
+    /// @brief Reads a 3D point, vector or normal written by
+    /// BinaryWriter::writeXYZ().
+    template <typename T>
+    T readXYZ() {
+        const f64 x = read<f64>();
+        const f64 y = read<f64>();
+        const f64 z = read<f64>();
+        return T(x, y, z);
+    }
+
+    /// @brief Retrieves the number of unread bytes.
+    Size remaining() const;
+
+private:
+    std::span<const u8> mBytes;
+    Index mOffset;
+};
@@ -0,0 +1,57 @@
+#include "util/framebuffer.hpp"
+
+Framebuffer::Framebuffer(const Size width, const Size height)
+    : mWidth(width),
+      mHeight(height),
+      mSum(width * height, Vector3D::zero()),
+      mCount(width * height, 0) {
+}
+
+void Framebuffer::add(
+    const Index i, const Index j, const Vector3D& sum, const Size count
+) {
+    assertm(i < mWidth, "i must be less than framebuffer width");
+    assertm(j < mHeight, "j must be less than framebuffer height");
+
+    mSum[j * mWidth + i] += sum;
+    mCount[j * mWidth + i] += count;
+}
+
+Vector3D Framebuffer::mean(const Index i, const Index j) const {
+    assertm(i < mWidth, "i must be less than framebuffer width");
+    assertm(j < mHeight, "j must be less than framebuffer height");
+
+    const Size count = mCount[j * mWidth + i];
+    if (count == 0)
+        return Vector3D::zero();
+
+    return mSum[j * mWidth + i] * (1.0 / static_cast<f64>(count));
+}
+
+Vector3D Framebuffer::sum(const Index i, const Index j) const {
+    assertm(i < mWidth, "i must be less than framebuffer width");
+    assertm(j < mHeight, "j must be less than framebuffer height");
+
+    return mSum[j * mWidth + i];
+}
+
+Size Framebuffer::count(const Index i, const Index j) const {
+    assertm(i < mWidth, "i must be less than framebuffer width");
+    assertm(j < mHeight, "j must be less than framebuffer height");
+
+    return mCount[j * mWidth + i];
+}
+
+void Framebuffer::resolve(Image& image) const {
+    for (Index j = 0; j < mHeight; ++j)
+        for (Index i = 0; i < mWidth; ++i)
+            image.set(i, j, mean(i, j));
+}
+
+Size Framebuffer::width() const {
+    return mWidth;
+}
+
+Size Framebuffer::height() const {
+    return mHeight;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include "math/vector.hpp"
+#include "prelude.hpp"
+#include "util/image.hpp"
+
+/// @brief Floating point accumulation buffer. Keeps the running sum and the
+/// sample count of every pixel, so that a render can be refined in passes and
+/// resolved to an Image at any point.
+class Framebuffer {
+public:
+    Framebuffer(const Size width, const Size height);
+    ~Framebuffer() = default;
+
+    /// @brief Adds `count` samples whose colors sum to `sum` to pixel (i, j).
+    void add(
+        const Index i, const Index j, const Vector3D& sum, const Size count
+    );
+
+    /// @brief Retrieves the mean color of pixel (i, j). Pixels without samples
+    /// are black.
+    Vector3D mean(const Index i, const Index j) const;
+
+    /// @brief Retrieves the sum of the sample colors of pixel (i, j).
+    Vector3D sum(const Index i, const Index j) const;
+
+    /// @brief Retrieves the number of samples taken in pixel (i, j).
+    Size count(const Index i, const Index j) const;
+
+    /// @brief Writes the mean color of every pixel to the image.
+    void resolve(Image& image) const;
+
+    Size width() const;
+    Size height() const;
+
+private:
+    Size mWidth;
+    Size mHeight;
+    std::vector<Vector3D> mSum;
+    std::vector<Size> mCount;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "prelude.hpp"
+#include "util/pcg.hpp"
+
+/// @brief Incremental 64-bit content hash. Bytes are consumed eight at a time
+/// and folded into the state with the SplitMix64 finalizer. Suited to cache
+/// keys, not to cryptographic use.
+class Hasher {
+public:
+    Hasher() = default;
+
+    /// @brief Adds the raw bytes to the hash.
+    void addBytes(const void* data, const Size size) {
+        const u8* bytes = static_cast<const u8*>(data);
+
+        Index i = 0;
+        for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+            u64 word;
+            std::memcpy(&word, bytes + i, sizeof(u64));
+            mState = pcg::mix(mState ^ word);
+        }
+
+        if (i < size) {
+            u64 word = 0;
+            std::memcpy(&word, bytes + i, size - i);
+            mState = pcg::mix(mState ^ word ^ (u64(size - i) << 56));
+        }
+    }
+
+    /// @brief Adds the object representation of the value. The type must have
+    /// no padding, otherwise the hash depends on indeterminate bytes.
+    template <typename T>
+    void add(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        addBytes(&value, sizeof(T));
+    }
+
+    /// @brief Adds the length and the elements of the vector.
+    template <typename T>
+    void addVector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        add<u64>(values.size());
+        addBytes(values.data(), values.size() * sizeof(T));
+    }
+
+    /// @brief Retrieves the hash of everything added so far.
+    u64 value() const {
+        return mState;
+    }
+
+private:
+    u64 mState = 0x9e3779b97f4a7c15ull;
+};
@@ -43,3 +43,7 @@ void Image::save(const char* path) const {
     if (!error)
         Log::f("Failed to save image");
 }
+
+std::span<const u8> Image::data() const {
+    return std::span<const u8>(mData, mWidth * mHeight * 3);
+}
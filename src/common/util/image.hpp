@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 #include "math/vector.hpp"
 #include "prelude.hpp"
 
@@ -16,6 +18,9 @@ public:
     /// @brief Saves the image as a PNG to the specified path.
     void save(const char* path) const;
 
+    /// @brief Retrieves the 8-bit RGB values of the pixels, row by row.
+    std::span<const u8> data() const;
+
 private:
     Size mWidth;
     Size mHeight;
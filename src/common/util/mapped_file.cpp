@@ -0,0 +1,72 @@
+#include "util/mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+MappedFile::MappedFile(const char* path) : mData(nullptr), mSize(0) {
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("could not open file: " + std::string(path));
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("could not stat file: " + std::string(path));
+    }
+
+    mSize = static_cast<Size>(info.st_size);
+
+    // mmap rejects empty mappings, so empty files map to an empty span.
+    if (mSize > 0) {
+        void* data = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error(
+                "could not map file: " + std::string(path)
+            );
+        }
+        mData = static_cast<const u8*>(data);
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mData(std::exchange(other.mData, nullptr)),
+      mSize(std::exchange(other.mSize, 0)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        mData = std::exchange(other.mData, nullptr);
+        mSize = std::exchange(other.mSize, 0);
+    }
+    return *this;
+}
+
+std::span<const u8> MappedFile::bytes() const {
+    return std::span<const u8>(mData, mSize);
+}
+
+Size MappedFile::size() const {
+    return mSize;
+}
+
+void MappedFile::release() {
+    if (mData != nullptr)
+        ::munmap(const_cast<u8*>(mData), mSize);
+    mData = nullptr;
+    mSize = 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <span>
+
+#include "prelude.hpp"
+
+/// @brief Read-only memory mapping of a whole file. The mapping is released
+/// when the object is destroyed.
+class MappedFile {
+public:
+    /// @brief Maps the file at the path.
+    /// @throws std::runtime_error if the file cannot be opened or mapped.
+    explicit MappedFile(const char* path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// @brief Retrieves the mapped bytes.
+    std::span<const u8> bytes() const;
+
+    /// @brief Retrieves the file size in bytes.
+    Size size() const;
+
+private:
+    /// @brief Unmaps the file.
+    void release();
+
+    const u8* mData;
+    Size mSize;
+};
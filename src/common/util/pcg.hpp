@@ -0,0 +1,72 @@
+#pragma once
+
+#include "prelude.hpp"
+
+/// @brief PCG32 pseudorandom number generator (XSH RR variant). Holds 16 bytes
+/// of state and supports 2^63 independent streams selected at seeding.
+class PCG32 {
+public:
+    PCG32() : PCG32(0, 0) {
+    }
+
+    PCG32(const u64 seed, const u64 stream) {
+        reseed(seed, stream);
+    }
+
+    ~PCG32() = default;
+
+    /// @brief Restarts the generator at `seed` on the given stream.
+    void reseed(const u64 seed, const u64 stream) {
+        mState = 0;
+        mIncrement = (stream << 1) | 1;
+        next();
+        mState += seed;
+        next();
+    }
+
+    /// @brief Generates the next uniformly distributed 32-bit value.
+    u32 next() {
+        const u64 state = mState;
+        mState = state * cMultiplier + mIncrement;
+
+        const u32 xorshifted = static_cast<u32>(((state >> 18) ^ state) >> 27);
+        const u32 rotation = static_cast<u32>(state >> 59);
+        return (xorshifted >> rotation) |
+               (xorshifted << ((~rotation + 1) & 31));
+    }
+
+    /// @brief Generates a uniformly distributed value in [0, 1).
+    template <std::floating_point T>
+    T uniform() {
+        if constexpr (sizeof(T) > sizeof(f32)) {
+            // Use 53 bits from two outputs to fill the double mantissa.
+            const u64 high = next();
+            const u64 low = next();
+            return static_cast<T>(((high << 32) | low) >> 11) * T(0x1p-53);
+        } else {
+            return static_cast<T>(next() >> 8) * T(0x1p-24);
+        }
+    }
+
+private:
+    static constexpr u64 cMultiplier = 6364136223846793005ull;
+
+    u64 mState;
+    u64 mIncrement;
+};
+
+namespace pcg {
+
+/// @brief Mixes a 64-bit value into a well distributed 64-bit hash
+/// (SplitMix64 finalizer). Used to derive seeds from structured inputs such
+/// as pixel coordinates.
+inline u64 mix(u64 value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    value ^= value >> 31;
+    return value;
+}
+
+};
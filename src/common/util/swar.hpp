@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstring>
+#include <string_view>
+
+#include "prelude.hpp"
+
+/// @brief SIMD within a register: byte scans that test eight bytes of text
+/// per step in a 64-bit word, without depending on an instruction set.
+namespace swar {
+
+/// @brief Retrieves a word with every byte set to `byte`.
+constexpr u64 broadcast(const u8 byte) {
+    return 0x0101010101010101ull * byte;
+}
+
+/// @brief Determines whether any byte of the word is less than `bound`,
+/// which must be at most 128. Bytes of 128 and above never match.
+constexpr bool hasLess(const u64 word, const u8 bound) {
+    return ((word - broadcast(bound)) & ~word & broadcast(0x80)) != 0;
+}
+
+/// @brief Finds the first byte of the text that is a space or a control
+/// character, which includes every whitespace and newline character.
+/// @returns The index of the byte, or the size of the text if there is none.
+inline Index findSpaceOrControl(const std::string_view text) {
+    Index i = 0;
+    for (; i + sizeof(u64) <= text.size(); i += sizeof(u64)) {
+        u64 word;
+        std::memcpy(&word, text.data() + i, sizeof(u64));
+        if (hasLess(word, ' ' + 1))
+            break;
+    }
+
+    // The word test only tells whether a byte matches, so the match is
+    // located within the word one byte at a time.
+    for (; i < text.size(); ++i) {
+        if (static_cast<u8>(text[i]) <= ' ')
+            return i;
+    }
+
+    return text.size();
+}
+
+}
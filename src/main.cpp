@@ -1,15 +1,37 @@
 #include <Python.h>
 
 #include <cstdlib>
+#include <stdexcept>
 #include <string_view>
 
+#include "render/pathtracer.hpp"
+#include "render/worker_pool.hpp"
 #include "util/format.hpp"
+#include "util/log.hpp"
 
 void usage() {
     eprintln("Usage: Glacier <scene_python_script_file_path>");
+    eprintln("       Glacier --worker <host:port>");
+}
+
+/// @brief Renders the tiles of distributed renders whose coordinators connect
+/// to the address. Serves one render at a time until the process is stopped.
+int worker(const char* address) {
+    try {
+        const int listener = WorkerPool::listen(address);
+        Log::i("Worker listening on {}", address);
+        WorkerPool::serveJobs(listener, &Pathtracer::startWorker);
+    } catch (const std::runtime_error& e) {
+        eprintln("Error: {}", e.what());
+    }
+
+    return EXIT_FAILURE;
 }
 
 int main(int argc, char** argv) {
+    if (argc == 3 && std::string_view(argv[1]) == "--worker")
+        return worker(argv[2]);
+
     if (argc != 2) {
         usage();
         return EXIT_FAILURE;
@@ -0,0 +1,197 @@
+#include "bvh_tree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+/// @brief Depth after which subtrees are split at the median so that the
+/// traversal stack cannot overflow.
+constexpr Size cMedianDepth = 32;
+
+/// @brief Rounds a bound down to the nearest single precision value.
+f32 roundDown(const f64 value) {
+    const f32 rounded = static_cast<f32>(value);
+    if (static_cast<f64>(rounded) > value)
+        return std::nextafter(rounded, -math::infinity<f32>());
+    return rounded;
+}
+
+/// @brief Rounds a bound up to the nearest single precision value.
+f32 roundUp(const f64 value) {
+    const f32 rounded = static_cast<f32>(value);
+    if (static_cast<f64>(rounded) < value)
+        return std::nextafter(rounded, math::infinity<f32>());
+    return rounded;
+}
+
+void setBounds(LinearBVHNode& node, const AABB& bbox) {
+    for (Index i = 0; i < 3; ++i) {
+        node.min[i] = roundDown(bbox.axis(i).min);
+        node.max[i] = roundUp(bbox.axis(i).max);
+    }
+}
+
+AABB nodeBounds(const LinearBVHNode& node) {
+    return AABB(
+        Point3D(node.min[0], node.min[1], node.min[2]),
+        Point3D(node.max[0], node.max[1], node.max[2])
+    );
+}
+
+}
+
+BVHTree::BVHTree() : mNodes(), mItems(), mParams(), mMaxLeafSize(1) {
+}
+
+void BVHTree::build(
+    std::vector<BuildRef> refs,
+    const SAHParams& params,
+    const Size max_leaf_size
+) {
+    assertm(max_leaf_size >= 1, "max leaf size must be at least 1");
+
+    mParams = params;
+    mMaxLeafSize =
+        std::min<Size>(max_leaf_size, std::numeric_limits<u16>::max());
+
+    mNodes.clear();
+    mItems.clear();
+
+    if (refs.empty())
+        return;
+
+    mNodes.reserve(2 * refs.size() - 1);
+    mItems.reserve(refs.size());
+
+    buildRecursive(std::span<BuildRef>(refs), 0);
+
+    mNodes.shrink_to_fit();
+}
+
+const std::vector<LinearBVHNode>& BVHTree::nodes() const {
+    return mNodes;
+}
+
+const std::vector<Index>& BVHTree::items() const {
+    return mItems;
+}
+
+AABB BVHTree::aabb() const {
+    if (mNodes.empty())
+        return AABB::empty;
+    return nodeBounds(mNodes.front());
+}
+
+f64 BVHTree::sahCost(const SAHParams& params) const {
+    if (mNodes.empty())
+        return 0.0;
+
+    f64 cost = 0.0;
+    for (const LinearBVHNode& node : mNodes) {
+        const f64 area = nodeBounds(node).surfaceArea();
+        if (node.isLeaf())
+            cost += sah::leafCost(node.itemCount, params) * area;
+        else
+            cost += params.traversalCost * area;
+    }
+
+    return cost / aabb().surfaceArea();
+}
+
+void BVHTree::save(BinaryWriter& writer) const {
+    writer.write(mParams);
+    writer.write<u64>(mMaxLeafSize);
+    writer.writeVector(mNodes);
+    writer.writeVector(mItems);
+}
+
+void BVHTree::load(BinaryReader& reader) {
+    mParams = reader.read<SAHParams>();
+    mMaxLeafSize = reader.read<u64>();
+    mNodes = reader.readVector<LinearBVHNode>();
+    mItems = reader.readVector<Index>();
+
+    // Traversal trusts the child offsets and item ranges, so reject trees
+    // that would index out of bounds.
+    for (Index i = 0; i < mNodes.size(); ++i) {
+        const LinearBVHNode& node = mNodes[i];
+        const bool valid =
+            node.isLeaf()
+                ? node.itemOffset + node.itemCount <= mItems.size()
+                : i + 1 < mNodes.size() && node.secondChild > i &&
+                      node.secondChild < mNodes.size() && node.axis < 3;
+        if (!valid)
+            throw std::runtime_error("malformed BVH node");
+    }
+}
+
+Index BVHTree::buildRecursive(std::span<BuildRef> refs, const Size depth) {
+    const Index node_index = mNodes.size();
+    mNodes.emplace_back();
+
+    AABB bbox = AABB::empty;
+    AABB centroids = AABB::empty;
+    for (const BuildRef& ref : refs) {
+        bbox = bbox.enclosure(ref.bbox);
+        centroids = centroids.enclosure(AABB(ref.centroid, ref.centroid));
+    }
+
+    setBounds(mNodes[node_index], bbox);
+
+    auto make_leaf = [&]() {
+        LinearBVHNode& node = mNodes[node_index];
+        node.itemOffset = static_cast<u32>(mItems.size());
+        node.itemCount = static_cast<u16>(refs.size());
+        node.axis = 0;
+        for (const BuildRef& ref : refs)
+            mItems.push_back(ref.index);
+        return node_index;
+    };
+
+    if (refs.size() == 1)
+        return make_leaf();
+
+    Index axis = centroids.longestAxis();
+    Index middle = 0;
+
+    const Option<sah::Split> split =
+        (depth < cMedianDepth)
+            ? sah::findSplit(refs, bbox, centroids, mParams)
+            : std::nullopt;
+
+    if (split) {
+        // Terminate if intersecting every item is cheaper than splitting.
+        if (refs.size() <= mMaxLeafSize &&
+            sah::leafCost(refs.size(), mParams) <= split->cost)
+            return make_leaf();
+
+        axis = split->axis;
+        middle = sah::partition(refs, centroids, *split, mParams.binCount);
+    } else {
+        if (refs.size() <= mMaxLeafSize)
+            return make_leaf();
+
+        middle = refs.size() / 2;
+        std::nth_element(
+            std::begin(refs),
+            std::begin(refs) + middle,
+            std::end(refs),
+            [axis](const BuildRef& left, const BuildRef& right) {
+                return left.centroid[axis] < right.centroid[axis];
+            }
+        );
+    }
+
+    buildRecursive(refs.subspan(0, middle), depth + 1);
+    const Index second = buildRecursive(refs.subspan(middle), depth + 1);
+
+    LinearBVHNode& node = mNodes[node_index];
+    node.secondChild = static_cast<u32>(second);
+    node.itemCount = 0;
+    node.axis = static_cast<u8>(axis);
+
+    return node_index;
+}
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <span>
+#include <vector>
+
+#include "common/math/aabb.hpp"
+#include "common/math/interval.hpp"
+#include "common/math/ray.hpp"
+#include "common/math/traversal_ray.hpp"
+#include "common/prelude.hpp"
+#include "common/util/binary_io.hpp"
+#include "sah.hpp"
+
+/// @brief Compact 32-byte BVH node. Bounds are stored in single precision and
+/// rounded outwards so that they still enclose the double precision bounds.
+/// Interior nodes are followed immediately by their first child and store the
+/// offset of their second child. Leaves store a range of item slots.
+struct LinearBVHNode {
+    f32 min[3];
+    f32 max[3];
+    union {
+        u32 itemOffset;
+        u32 secondChild;
+    };
+    u16 itemCount;
+    u8 axis;
+    u8 pad;
+
+    /// @brief Determines whether the node is a leaf.
+    bool isLeaf() const {
+        return itemCount > 0;
+    }
+};
+
+static_assert(sizeof(LinearBVHNode) == 32, "LinearBVHNode must be 32 bytes");
+
+/// @brief Flattened, pointer-free bounding volume hierarchy over an arbitrary
+/// set of bounded items. Nodes are stored contiguously in depth-first order
+/// and traversed with an explicit stack.
+class BVHTree {
+public:
+    /// @brief Maximum number of rays in a packet.
+    static constexpr Size MAX_PACKET = 64;
+
+    BVHTree();
+    ~BVHTree() = default;
+
+    /// @brief Builds the tree over the references with the binned SAH. Leaves
+    /// hold at most `max_leaf_size` items.
+    void build(
+        std::vector<BuildRef> refs,
+        const SAHParams& params,
+        const Size max_leaf_size
+    );
+
+    /// @brief Retrieves a constant reference to the node array.
+    const std::vector<LinearBVHNode>& nodes() const;
+
+    /// @brief Retrieves the item index stored in each leaf slot.
+    const std::vector<Index>& items() const;
+
+    /// @brief Retrieves the bounds of the whole tree.
+    AABB aabb() const;
+
+    /// @brief Computes the SAH cost of the tree, normalized by the surface
+    /// area of the root.
+    f64 sahCost(const SAHParams& params) const;
+
+    /// @brief Writes the built tree.
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Replaces the tree with one written by save().
+    /// @throws std::runtime_error if the data is truncated or malformed.
+    void load(BinaryReader& reader);
+
+    /// @brief Traverses the tree front to back and calls `visit(item, bounds)`
+    /// for each item in every leaf entered by the ray. `visit` returns true if
+    /// the item was hit, in which case it must have shrunk `bounds.max` to
+    /// the hit parameter.
+    /// @returns Whether any item was hit.
+    template <typename Visitor>
+    bool traverse(const Ray& ray, Interval& bounds, Visitor&& visit) const;
+
+    /// @brief Traverses the tree and calls `visit(item)` for each item in
+    /// every leaf entered by the ray until `visit` returns true. Suited to
+    /// any-hit queries, where the order of the hits does not matter.
+    /// @returns Whether `visit` returned true for any item.
+    template <typename Visitor>
+    bool traverseAny(
+        const Ray& ray, const Interval& bounds, Visitor&& visit
+    ) const;
+
+    /// @brief Traverses the tree like traverse(), but calls
+    /// `visit(leaf, bounds)` once for every leaf entered by the ray, so that
+    /// callers can test all of its items at once.
+    /// @returns Whether any leaf was hit.
+    template <typename Visitor>
+    bool traverseLeaves(
+        const Ray& ray, Interval& bounds, Visitor&& visit
+    ) const;
+
+    /// @brief Traverses the tree like traverseAny(), but calls `visit(leaf)`
+    /// once for every leaf entered by the ray until it returns true.
+    /// @returns Whether `visit` returned true for any leaf.
+    template <typename Visitor>
+    bool traverseAnyLeaves(
+        const Ray& ray, const Interval& bounds, Visitor&& visit
+    ) const;
+
+    /// @brief Traverses the tree with the rays selected by `mask` from a
+    /// packet of up to MAX_PACKET coherent rays, and calls
+    /// `visit(leaf, leaf_mask)` for every leaf entered by any of them, where
+    /// bit i of `leaf_mask` is set if ray i enters the leaf. `visit` must
+    /// shrink `bounds[i].max` to the hit parameter of every ray it hits.
+    /// Nodes are fetched once for the packet, and each node is tested
+    /// against the active rays only until the first and last entering rays
+    /// are found. The rays between them stay active without a test, so a
+    /// coherent packet mostly costs two box tests per node. Packets of rays
+    /// with a shared origin, like camera rays, first test each node against
+    /// the interval of their directions, which culls nodes no ray enters
+    /// with one test. Children are visited in the order of the first active
+    /// ray.
+    template <typename Visitor>
+    void traversePacket(
+        std::span<const Ray> rays,
+        const u64 mask,
+        std::span<Interval> bounds,
+        Visitor&& visit
+    ) const;
+
+private:
+    /// @brief Maximum traversal stack depth.
+    static constexpr Size MAX_DEPTH = 64;
+
+    /// @brief Recursively builds the subtree over the references and appends
+    /// its nodes in depth-first order.
+    /// @returns The index of the subtree root.
+    Index buildRecursive(std::span<BuildRef> refs, const Size depth);
+
+    /// @brief Branchless slab test between the ray and the node bounds,
+    /// like AABB::checkIntersect().
+    static bool checkIntersect(
+        const LinearBVHNode& node,
+        const TraversalRay& ray,
+        const Interval& bounds
+    );
+
+    std::vector<LinearBVHNode> mNodes;
+    std::vector<Index> mItems;
+    SAHParams mParams;
+    Size mMaxLeafSize;
+};
+
+inline bool BVHTree::checkIntersect(
+    const LinearBVHNode& node, const TraversalRay& ray, const Interval& bounds
+) {
+    f64 t_min = bounds.min;
+    f64 t_max = bounds.max;
+
+    for (Index i = 0; i < 3; ++i) {
+        const f32 near = ray.dirIsNeg[i] ? node.max[i] : node.min[i];
+        const f32 far = ray.dirIsNeg[i] ? node.min[i] : node.max[i];
+
+        const f64 t0 = (static_cast<f64>(near) - ray.origin[i]) * ray.invDir[i];
+        const f64 t1 = (static_cast<f64>(far) - ray.origin[i]) * ray.invDir[i];
+
+        t_min = t0 > t_min ? t0 : t_min;
+        t_max = t1 < t_max ? t1 : t_max;
+    }
+
+    return t_min <= t_max;
+}
+
+template <typename Visitor>
+bool BVHTree::traverse(
+    const Ray& ray, Interval& bounds, Visitor&& visit
+) const {
+    return traverseLeaves(
+        ray,
+        bounds,
+        [&](const LinearBVHNode& leaf, Interval& bounds) {
+            bool hit = false;
+            for (Index i = 0; i < leaf.itemCount; ++i) {
+                if (visit(mItems[leaf.itemOffset + i], bounds))
+                    hit = true;
+            }
+            return hit;
+        }
+    );
+}
+
+template <typename Visitor>
+bool BVHTree::traverseAny(
+    const Ray& ray, const Interval& bounds, Visitor&& visit
+) const {
+    return traverseAnyLeaves(ray, bounds, [&](const LinearBVHNode& leaf) {
+        for (Index i = 0; i < leaf.itemCount; ++i) {
+            if (visit(mItems[leaf.itemOffset + i]))
+                return true;
+        }
+        return false;
+    });
+}
+
+template <typename Visitor>
+bool BVHTree::traverseLeaves(
+    const Ray& ray, Interval& bounds, Visitor&& visit
+) const {
+    if (mNodes.empty())
+        return false;
+
+    const TraversalRay traversal_ray(ray);
+
+    bool hit = false;
+
+    Index stack[MAX_DEPTH];
+    Size stack_size = 0;
+    Index current = 0;
+
+    while (true) {
+        const LinearBVHNode& node = mNodes[current];
+
+        if (checkIntersect(node, traversal_ray, bounds)) {
+            if (node.isLeaf()) {
+                if (visit(node, bounds))
+                    hit = true;
+            } else if (traversal_ray.dirIsNeg[node.axis]) {
+                // Visit the second child first, as it is nearer to the ray
+                // origin along the split axis.
+                stack[stack_size++] = current + 1;
+                current = node.secondChild;
+                continue;
+            } else {
+                stack[stack_size++] = node.secondChild;
+                current = current + 1;
+                continue;
+            }
+        }
+
+        if (stack_size == 0)
+            break;
+        current = stack[--stack_size];
+    }
+
+    return hit;
+}
+
+template <typename Visitor>
+bool BVHTree::traverseAnyLeaves(
+    const Ray& ray, const Interval& bounds, Visitor&& visit
+) const {
+    if (mNodes.empty())
+        return false;
+
+    const TraversalRay traversal_ray(ray);
+
+    Index stack[MAX_DEPTH];
+    Size stack_size = 0;
+    Index current = 0;
+
+    while (true) {
+        const LinearBVHNode& node = mNodes[current];
+
+        if (checkIntersect(node, traversal_ray, bounds)) {
+            if (node.isLeaf()) {
+                if (visit(node))
+                    return true;
+            } else {
+                stack[stack_size++] = node.secondChild;
+                current = current + 1;
+                continue;
+            }
+        }
+
+        if (stack_size == 0)
+            break;
+        current = stack[--stack_size];
+    }
+
+    return false;
+}
+
+template <typename Visitor>
+void BVHTree::traversePacket(
+    std::span<const Ray> rays,
+    const u64 mask,
+    std::span<Interval> bounds,
+    Visitor&& visit
+) const {
+    assertm(rays.size() <= MAX_PACKET, "packet has too many rays");
+    assertm(rays.size() == bounds.size(), "packet bounds do not match rays");
+
+    if (mNodes.empty() || mask == 0)
+        return;
+
+    Option<TraversalRay> traversal_rays[MAX_PACKET];
+    for (u64 bits = mask; bits != 0; bits &= bits - 1) {
+        const Index i = std::countr_zero(bits);
+        traversal_rays[i].emplace(rays[i]);
+    }
+
+    auto enters = [&](const LinearBVHNode& node, const Index i) {
+        return ((mask >> i) & 1) &&
+               checkIntersect(node, *traversal_rays[i], bounds[i]);
+    };
+
+    // Bound the reciprocal directions and parameter bounds of the packet.
+    // Bounds only shrink during traversal, so the initial ones stay valid.
+    const Index lead = std::countr_zero(mask);
+    const Point3D& origin = rays[lead].origin;
+    Vector3D inv_min = traversal_rays[lead]->invDir;
+    Vector3D inv_max = traversal_rays[lead]->invDir;
+    f64 packet_min = bounds[lead].min;
+    f64 packet_max = bounds[lead].max;
+    bool shared_origin = true;
+
+    for (u64 bits = mask; bits != 0; bits &= bits - 1) {
+        const Index i = std::countr_zero(bits);
+        const Point3D& o = rays[i].origin;
+        shared_origin = shared_origin && o.x == origin.x && o.y == origin.y &&
+                        o.z == origin.z;
+        inv_min = inv_min.min(traversal_rays[i]->invDir);
+        inv_max = inv_max.max(traversal_rays[i]->invDir);
+        packet_min = std::min(packet_min, bounds[i].min);
+        packet_max = std::max(packet_max, bounds[i].max);
+    }
+
+    // The interval test needs finite reciprocal directions of one sign per
+    // axis, so that the near and far planes are the same for every ray.
+    bool interval_test = shared_origin;
+    for (Index axis = 0; axis < 3; ++axis)
+        interval_test = interval_test && std::isfinite(inv_min[axis]) &&
+                        std::isfinite(inv_max[axis]) &&
+                        (inv_min[axis] > 0.0 || inv_max[axis] < 0.0);
+
+    // Bounds the slab parameters of every ray with interval arithmetic. Each
+    // product is rounded the same way as in checkIntersect(), so a node
+    // entered by any ray is never culled.
+    auto culled = [&](const LinearBVHNode& node) {
+        f64 t_min = packet_min;
+        f64 t_max = packet_max;
+
+        for (Index axis = 0; axis < 3; ++axis) {
+            const bool negative = inv_max[axis] < 0.0;
+            const f64 near =
+                static_cast<f64>(negative ? node.max[axis] : node.min[axis]) -
+                origin[axis];
+            const f64 far =
+                static_cast<f64>(negative ? node.min[axis] : node.max[axis]) -
+                origin[axis];
+
+            t_min = std::max(
+                t_min, near * (near >= 0.0 ? inv_min[axis] : inv_max[axis])
+            );
+            t_max = std::min(
+                t_max, far * (far >= 0.0 ? inv_max[axis] : inv_min[axis])
+            );
+        }
+
+        return t_max < t_min;
+    };
+
+    // Pending nodes with the range of rays that are active in them.
+    struct Entry {
+        u32 node;
+        u32 first;
+        u32 end;
+    };
+
+    // Both children are pushed, so the stack holds one more entry than in
+    // single ray traversal.
+    Entry stack[MAX_DEPTH + 1];
+    Size stack_size = 0;
+    stack[stack_size++] = Entry{
+        0,
+        static_cast<u32>(std::countr_zero(mask)),
+        static_cast<u32>(64 - std::countl_zero(mask))
+    };
+
+    while (stack_size > 0) {
+        const Entry entry = stack[--stack_size];
+        const LinearBVHNode& node = mNodes[entry.node];
+
+        if (interval_test && culled(node))
+            continue;
+
+        Index first = entry.first;
+        while (first < entry.end && !enters(node, first))
+            ++first;
+        if (first == entry.end)
+            continue;
+
+        Index end = entry.end;
+        while (end - 1 > first && !enters(node, end - 1))
+            --end;
+
+        if (node.isLeaf()) {
+            // Primitive tests cost more than box tests, so rays between the
+            // first and last are tested against the leaf box itself.
+            u64 leaf_mask = u64(1) << first;
+            for (Index i = first + 1; i < end; ++i) {
+                if (i == end - 1 || enters(node, i))
+                    leaf_mask |= u64(1) << i;
+            }
+            visit(node, leaf_mask);
+            continue;
+        }
+
+        const u32 first_child = entry.node + 1;
+        const u32 second_child = node.secondChild;
+        const bool second_first = traversal_rays[first]->dirIsNeg[node.axis];
+
+        const u32 near = second_first ? second_child : first_child;
+        const u32 far = second_first ? first_child : second_child;
+        stack[stack_size++] =
+            Entry{far, static_cast<u32>(first), static_cast<u32>(end)};
+        stack[stack_size++] =
+            Entry{near, static_cast<u32>(first), static_cast<u32>(end)};
+    }
+}
@@ -0,0 +1,120 @@
+#include "sah.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+/// @brief Accumulated bounds and item count of a single bin.
+struct Bin {
+    AABB bbox = AABB::empty;
+    Size count = 0;
+};
+
+}
+
+namespace sah {
+
+Index bin(
+    const Point3D& centroid,
+    const AABB& centroid_bbox,
+    const Index axis,
+    const Size bin_count
+) {
+    const Interval& extent = centroid_bbox.axis(axis);
+    assertm(extent.size() > 0, "Centroid extent of the axis must be positive");
+
+    const f64 offset = (centroid[axis] - extent.min) / extent.size();
+    const Index b = static_cast<Index>(offset * static_cast<f64>(bin_count));
+    return std::min(b, bin_count - 1);
+}
+
+Option<Split> findSplit(
+    std::span<const BuildRef> refs,
+    const AABB& bbox,
+    const AABB& centroid_bbox,
+    const SAHParams& params
+) {
+    assertm(params.binCount >= 2, "SAH bin count must be at least 2");
+
+    const Size bin_count = params.binCount;
+    const f64 inv_area = 1.0 / bbox.surfaceArea();
+
+    Option<Split> best = std::nullopt;
+
+    std::vector<Bin> bins(bin_count);
+    std::vector<f64> right_areas(bin_count);
+    std::vector<Size> right_counts(bin_count);
+
+    for (Index axis = 0; axis < 3; ++axis) {
+        // All centroids lie in the same plane along this axis, so no split
+        // separates them, and the bins are undefined.
+        if (centroid_bbox.axis(axis).size() <= 0)
+            continue;
+
+        std::fill(std::begin(bins), std::end(bins), Bin());
+
+        for (const BuildRef& ref : refs) {
+            Bin& b = bins[bin(ref.centroid, centroid_bbox, axis, bin_count)];
+            b.bbox = b.bbox.enclosure(ref.bbox);
+            ++b.count;
+        }
+
+        // Sweep from the right to accumulate the area and count of every
+        // suffix of bins.
+        AABB right_bbox = AABB::empty;
+        Size right_count = 0;
+        for (Index i = bin_count - 1; i > 0; --i) {
+            right_bbox = right_bbox.enclosure(bins[i].bbox);
+            right_count += bins[i].count;
+            right_areas[i] = right_bbox.surfaceArea();
+            right_counts[i] = right_count;
+        }
+
+        // Sweep from the left and evaluate the split after each bin.
+        AABB left_bbox = AABB::empty;
+        Size left_count = 0;
+        for (Index i = 0; i < bin_count - 1; ++i) {
+            left_bbox = left_bbox.enclosure(bins[i].bbox);
+            left_count += bins[i].count;
+
+            if (left_count == 0 || right_counts[i + 1] == 0)
+                continue;
+
+            const f64 cost =
+                params.traversalCost +
+                params.intersectionCost * inv_area *
+                    (static_cast<f64>(left_count) * left_bbox.surfaceArea() +
+                     static_cast<f64>(right_counts[i + 1]) *
+                         right_areas[i + 1]);
+
+            if (!best || cost < best->cost)
+                best = Split{axis, i, cost};
+        }
+    }
+
+    return best;
+}
+
+Index partition(
+    std::span<BuildRef> refs,
+    const AABB& centroid_bbox,
+    const Split& split,
+    const Size bin_count
+) {
+    const auto middle = std::partition(
+        std::begin(refs),
+        std::end(refs),
+        [&](const BuildRef& ref) {
+            return bin(ref.centroid, centroid_bbox, split.axis, bin_count) <=
+                   split.bin;
+        }
+    );
+    return static_cast<Index>(middle - std::begin(refs));
+}
+
+f64 leafCost(const Size count, const SAHParams& params) {
+    return params.intersectionCost * static_cast<f64>(count);
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <span>
+
+#include "common/math/aabb.hpp"
+#include "common/math/point.hpp"
+#include "common/prelude.hpp"
+
+/// @brief Reference to an item (primitive, triangle, ...) during hierarchy
+/// construction. Caches the worldspace bounds and centroid of the item.
+struct BuildRef {
+    AABB bbox;
+    Point3D centroid;
+    Index index;
+};
+
+/// @brief Binned surface area heuristic (SAH) cost model parameters.
+struct SAHParams {
+    /// @brief Number of centroid bins per axis.
+    Size binCount = 12;
+
+    /// @brief Estimated cost of visiting an interior node.
+    f64 traversalCost = 0.125;
+
+    /// @brief Estimated cost of intersecting a single item.
+    f64 intersectionCost = 1.0;
+};
+
+namespace sah {
+
+/// @brief Binned SAH split candidate. Items whose centroid falls into a bin
+/// less than or equal to `bin` along `axis` are placed on the left side.
+struct Split {
+    Index axis;
+    Index bin;
+    f64 cost;
+};
+
+/// @brief Determines the bin index of a centroid along the centroid bounds of
+/// the split axis. The centroid bounds must have a positive extent along it.
+Index bin(
+    const Point3D& centroid,
+    const AABB& centroid_bbox,
+    const Index axis,
+    const Size bin_count
+);
+
+/// @brief Finds the lowest cost binned SAH split of the references.
+/// @returns The split if one exists that places references on both sides,
+/// otherwise std::nullopt (e.g., if all centroids coincide).
+Option<Split> findSplit(
+    std::span<const BuildRef> refs,
+    const AABB& bbox,
+    const AABB& centroid_bbox,
+    const SAHParams& params
+);
+
+/// @brief Partitions the references about the split.
+/// @returns The number of references placed on the left side.
+Index partition(
+    std::span<BuildRef> refs,
+    const AABB& centroid_bbox,
+    const Split& split,
+    const Size bin_count
+);
+
+/// @brief Computes the cost of a leaf holding `count` items.
+f64 leafCost(const Size count, const SAHParams& params);
+
+}
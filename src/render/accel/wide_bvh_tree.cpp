@@ -0,0 +1,130 @@
+#include "wide_bvh_tree.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+/// @brief Computes the surface area of the bounds of a binary node.
+f64 surfaceArea(const LinearBVHNode& node) {
+    const f64 dx = static_cast<f64>(node.max[0]) - node.min[0];
+    const f64 dy = static_cast<f64>(node.max[1]) - node.min[1];
+    const f64 dz = static_cast<f64>(node.max[2]) - node.min[2];
+    return 2.0 * (dx * dy + dy * dz + dz * dx);
+}
+
+}
+
+WideBVHTree::WideBVHTree() : mNodes(), mItems(), mSahCost(0.0) {
+}
+
+void WideBVHTree::build(
+    std::vector<BuildRef> refs,
+    const SAHParams& params,
+    const Size max_leaf_size
+) {
+    BVHTree tree;
+    tree.build(std::move(refs), params, max_leaf_size);
+
+    mNodes.clear();
+    mItems = tree.items();
+    mSahCost = tree.sahCost(params);
+
+    if (tree.nodes().empty())
+        return;
+
+    // Every wide node replaces at least one interior binary node.
+    mNodes.reserve(tree.nodes().size() / 2 + 1);
+    collapse(tree, 0);
+    mNodes.shrink_to_fit();
+}
+
+const std::vector<WideBVHNode>& WideBVHTree::nodes() const {
+    return mNodes;
+}
+
+const std::vector<Index>& WideBVHTree::items() const {
+    return mItems;
+}
+
+f64 WideBVHTree::sahCost() const {
+    return mSahCost;
+}
+
+Index WideBVHTree::collapse(const BVHTree& tree, const Index binary_index) {
+    const std::vector<LinearBVHNode>& binary = tree.nodes();
+
+    // Open the interior child with the largest surface area until the node
+    // is full, as it is the most likely to be entered.
+    std::vector<Index> children;
+    if (binary[binary_index].isLeaf()) {
+        children.push_back(binary_index);
+    } else {
+        children.push_back(binary_index + 1);
+        children.push_back(binary[binary_index].secondChild);
+    }
+
+    while (children.size() < WideBVHNode::WIDTH) {
+        Option<Index> widest = std::nullopt;
+        f64 widest_area = 0.0;
+        for (Index i = 0; i < children.size(); ++i) {
+            const LinearBVHNode& child = binary[children[i]];
+            if (child.isLeaf())
+                continue;
+
+            const f64 area = surfaceArea(child);
+            if (!widest || area > widest_area) {
+                widest = i;
+                widest_area = area;
+            }
+        }
+
+        if (!widest)
+            break;
+
+        const Index opened = children[*widest];
+        children[*widest] = opened + 1;
+        children.push_back(binary[opened].secondChild);
+    }
+
+    const Index node_index = mNodes.size();
+    mNodes.emplace_back();
+
+    {
+        WideBVHNode& node = mNodes[node_index];
+        for (Index axis = 0; axis < 3; ++axis) {
+            std::fill_n(
+                node.min[axis],
+                WideBVHNode::WIDTH,
+                std::numeric_limits<f32>::infinity()
+            );
+            std::fill_n(
+                node.max[axis],
+                WideBVHNode::WIDTH,
+                -std::numeric_limits<f32>::infinity()
+            );
+        }
+        std::fill_n(node.child, WideBVHNode::WIDTH, 0);
+        std::fill_n(node.itemCount, WideBVHNode::WIDTH, 0);
+        std::fill_n(node.pad, sizeof(node.pad), 0);
+    }
+
+    for (Index i = 0; i < children.size(); ++i) {
+        const LinearBVHNode& child = binary[children[i]];
+
+        // Collapse before taking a reference, as it appends nodes.
+        const u32 target = child.isLeaf()
+                               ? child.itemOffset
+                               : static_cast<u32>(collapse(tree, children[i]));
+
+        WideBVHNode& node = mNodes[node_index];
+        for (Index axis = 0; axis < 3; ++axis) {
+            node.min[axis][i] = child.min[axis];
+            node.max[axis][i] = child.max[axis];
+        }
+        node.child[i] = target;
+        node.itemCount[i] = child.isLeaf() ? child.itemCount : 0;
+    }
+
+    return node_index;
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <vector>
+
+#include "bvh_tree.hpp"
+#include "common/math/interval.hpp"
+#include "common/math/ray.hpp"
+#include "common/math/traversal_ray.hpp"
+#include "common/prelude.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/// @brief 128-byte node with four children, whose bounds are stored axis by
+/// axis so that all four are slab-tested at once. Interior children store
+/// their node index and leaf children a range of item slots. Unused children
+/// have inverted bounds, which no ray enters.
+struct alignas(64) WideBVHNode {
+    /// @brief Number of children of a node.
+    static constexpr Size WIDTH = 4;
+
+    // Child bounds by axis and child, rounded outwards like LinearBVHNode.
+    f32 min[3][WIDTH];
+    f32 max[3][WIDTH];
+
+    // Node index of interior children, first item slot of leaf children.
+    u32 child[WIDTH];
+
+    // Item count of leaf children, 0 for interior and unused children.
+    u16 itemCount[WIDTH];
+
+    u8 pad[8];
+};
+
+static_assert(sizeof(WideBVHNode) == 128, "WideBVHNode must be 128 bytes");
+
+/// @brief Bounding volume hierarchy with four children per node, collapsed
+/// from a binary BVHTree. Wide nodes halve the depth of the tree, and their
+/// children are tested with one vectorized slab test and visited nearest
+/// first.
+class WideBVHTree {
+public:
+    WideBVHTree();
+    ~WideBVHTree() = default;
+
+    /// @brief Builds a binary tree over the references with the binned SAH
+    /// and collapses it. Leaves hold at most `max_leaf_size` items.
+    void build(
+        std::vector<BuildRef> refs,
+        const SAHParams& params,
+        const Size max_leaf_size
+    );
+
+    /// @brief Retrieves a constant reference to the node array.
+    const std::vector<WideBVHNode>& nodes() const;
+
+    /// @brief Retrieves the item index stored in each leaf slot.
+    const std::vector<Index>& items() const;
+
+    /// @brief Retrieves the SAH cost of the binary tree it was collapsed
+    /// from.
+    f64 sahCost() const;
+
+    /// @brief Traverses the tree nearest child first and calls
+    /// `visit(item, bounds)` for each item in every leaf entered by the ray.
+    /// `visit` returns true if the item was hit, in which case it must have
+    /// shrunk `bounds.max` to the hit parameter. Children entered beyond the
+    /// closest hit are skipped.
+    /// @returns Whether any item was hit.
+    template <typename Visitor>
+    bool traverse(const Ray& ray, Interval& bounds, Visitor&& visit) const;
+
+    /// @brief Traverses the tree and calls `visit(item)` for each item in
+    /// every leaf entered by the ray until `visit` returns true.
+    /// @returns Whether `visit` returned true for any item.
+    template <typename Visitor>
+    bool traverseAny(
+        const Ray& ray, const Interval& bounds, Visitor&& visit
+    ) const;
+
+private:
+    /// @brief Maximum traversal stack depth. Every node pushes at most
+    /// WIDTH - 1 entries beyond the one it replaces, and the binary tree is
+    /// at most 64 levels deep.
+    static constexpr Size MAX_STACK = 64 * (WideBVHNode::WIDTH - 1) + 1;
+
+    /// @brief Pending child on the traversal stack.
+    struct StackEntry {
+        u32 child;
+        u32 itemCount;
+        f64 t;
+    };
+
+    /// @brief Slab test between the ray and the bounds of every child of the
+    /// node. Stores the entry parameter of each child in `t_enter`.
+    /// @returns A mask with bit i set if child i is entered within the
+    /// bounds.
+    static u32 checkIntersect(
+        const WideBVHNode& node,
+        const TraversalRay& ray,
+        const Interval& bounds,
+        f64 t_enter[WideBVHNode::WIDTH]
+    );
+
+    /// @brief Collapses the binary subtree at `binary_index` into a wide
+    /// node and appends it and its descendants in depth-first order.
+    /// @returns The index of the wide node.
+    Index collapse(const BVHTree& tree, const Index binary_index);
+
+    std::vector<WideBVHNode> mNodes;
+    std::vector<Index> mItems;
+    f64 mSahCost;
+};
+
+inline u32 WideBVHTree::checkIntersect(
+    const WideBVHNode& node,
+    const TraversalRay& ray,
+    const Interval& bounds,
+    f64 t_enter[WideBVHNode::WIDTH]
+) {
+#ifdef __SSE2__
+    // Two halves of two children each, in double precision like
+    // BVHTree::checkIntersect. Max and min return their second operand if
+    // either is NaN, which leaves the interval unchanged.
+    __m128d t_min[2] = {_mm_set1_pd(bounds.min), _mm_set1_pd(bounds.min)};
+    __m128d t_max[2] = {_mm_set1_pd(bounds.max), _mm_set1_pd(bounds.max)};
+
+    for (Index axis = 0; axis < 3; ++axis) {
+        const f32* near = ray.dirIsNeg[axis] ? node.max[axis] : node.min[axis];
+        const f32* far = ray.dirIsNeg[axis] ? node.min[axis] : node.max[axis];
+        const __m128 near_ps = _mm_load_ps(near);
+        const __m128 far_ps = _mm_load_ps(far);
+
+        const __m128d origin = _mm_set1_pd(ray.origin[axis]);
+        const __m128d inv_dir = _mm_set1_pd(ray.invDir[axis]);
+
+        const __m128d near_pd[2] = {
+            _mm_cvtps_pd(near_ps), _mm_cvtps_pd(_mm_movehl_ps(near_ps, near_ps))
+        };
+        const __m128d far_pd[2] = {
+            _mm_cvtps_pd(far_ps), _mm_cvtps_pd(_mm_movehl_ps(far_ps, far_ps))
+        };
+
+        for (Index half = 0; half < 2; ++half) {
+            const __m128d t0 =
+                _mm_mul_pd(_mm_sub_pd(near_pd[half], origin), inv_dir);
+            const __m128d t1 =
+                _mm_mul_pd(_mm_sub_pd(far_pd[half], origin), inv_dir);
+            t_min[half] = _mm_max_pd(t0, t_min[half]);
+            t_max[half] = _mm_min_pd(t1, t_max[half]);
+        }
+    }
+
+    _mm_storeu_pd(t_enter, t_min[0]);
+    _mm_storeu_pd(t_enter + 2, t_min[1]);
+
+    const int low = _mm_movemask_pd(_mm_cmple_pd(t_min[0], t_max[0]));
+    const int high = _mm_movemask_pd(_mm_cmple_pd(t_min[1], t_max[1]));
+    return static_cast<u32>(low | (high << 2));
+#else
+    u32 mask = 0;
+    for (Index i = 0; i < WideBVHNode::WIDTH; ++i) {
+        f64 t_min = bounds.min;
+        f64 t_max = bounds.max;
+
+        for (Index axis = 0; axis < 3; ++axis) {
+            const f32 near =
+                ray.dirIsNeg[axis] ? node.max[axis][i] : node.min[axis][i];
+            const f32 far =
+                ray.dirIsNeg[axis] ? node.min[axis][i] : node.max[axis][i];
+            const f64 t0 = (near - ray.origin[axis]) * ray.invDir[axis];
+            const f64 t1 = (far - ray.origin[axis]) * ray.invDir[axis];
+
+            t_min = t0 > t_min ? t0 : t_min;
+            t_max = t1 < t_max ? t1 : t_max;
+        }
+
+        t_enter[i] = t_min;
+        if (t_min <= t_max)
+            mask |= 1 << i;
+    }
+    return mask;
+#endif
+}
+
+template <typename Visitor>
+bool WideBVHTree::traverse(
+    const Ray& ray, Interval& bounds, Visitor&& visit
+) const {
+    if (mNodes.empty())
+        return false;
+
+    const TraversalRay traversal_ray(ray);
+
+    bool hit = false;
+
+    StackEntry stack[MAX_STACK];
+    Size stack_size = 0;
+    stack[stack_size++] = StackEntry{0, 0, bounds.min};
+
+    while (stack_size > 0) {
+        const StackEntry entry = stack[--stack_size];
+
+        // Skip children entered beyond the closest hit found since they were
+        // pushed.
+        if (entry.t > bounds.max)
+            continue;
+
+        if (entry.itemCount > 0) {
+            for (Index i = 0; i < entry.itemCount; ++i) {
+                if (visit(mItems[entry.child + i], bounds))
+                    hit = true;
+            }
+            continue;
+        }
+
+        const WideBVHNode& node = mNodes[entry.child];
+        f64 t_enter[WideBVHNode::WIDTH];
+        const u32 mask = checkIntersect(node, traversal_ray, bounds, t_enter);
+
+        // Push the entered children farthest first, so the nearest is popped
+        // next.
+        StackEntry entered[WideBVHNode::WIDTH];
+        Size entered_count = 0;
+        for (Index i = 0; i < WideBVHNode::WIDTH; ++i) {
+            if (!(mask & (1 << i)))
+                continue;
+
+            const StackEntry child{
+                node.child[i], node.itemCount[i], t_enter[i]
+            };
+            Index j = entered_count++;
+            for (; j > 0 && entered[j - 1].t < child.t; --j)
+                entered[j] = entered[j - 1];
+            entered[j] = child;
+        }
+
+        for (Index i = 0; i < entered_count; ++i)
+            stack[stack_size++] = entered[i];
+    }
+
+    return hit;
+}
+
+template <typename Visitor>
+bool WideBVHTree::traverseAny(
+    const Ray& ray, const Interval& bounds, Visitor&& visit
+) const {
+    if (mNodes.empty())
+        return false;
+
+    const TraversalRay traversal_ray(ray);
+
+    StackEntry stack[MAX_STACK];
+    Size stack_size = 0;
+    stack[stack_size++] = StackEntry{0, 0, bounds.min};
+
+    while (stack_size > 0) {
+        const StackEntry entry = stack[--stack_size];
+
+        if (entry.itemCount > 0) {
+            for (Index i = 0; i < entry.itemCount; ++i) {
+                if (visit(mItems[entry.child + i]))
+                    return true;
+            }
+            continue;
+        }
+
+        const WideBVHNode& node = mNodes[entry.child];
+        f64 t_enter[WideBVHNode::WIDTH];
+        const u32 mask = checkIntersect(node, traversal_ray, bounds, t_enter);
+
+        for (Index i = 0; i < WideBVHNode::WIDTH; ++i) {
+            if (mask & (1 << i))
+                stack[stack_size++] =
+                    StackEntry{node.child[i], node.itemCount[i], t_enter[i]};
+        }
+    }
+
+    return false;
+}
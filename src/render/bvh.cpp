@@ -6,48 +6,40 @@ BVHPrim::BVHPrim(const PrimitivePtr& prim) : mPrimitive(prim) {
 }
 
 Option<SurfaceInteraction> BVHPrim::intersect(
-    const Ray& ray, const Interval& bounds
+    const Ray& ray, const TraversalRay& traversal_ray, const Interval& bounds
 ) const {
-    const Transform& object_to_world = mPrimitive->objectToWorld();
-    const Transform world_to_object = invert(object_to_world);
-
-    // Transform the ray with the primitive's world to object
-    // transformation.
-    const Ray inverse_ray = world_to_object(ray);
-
-    if (!mPrimitive->aabb().checkIntersect(inverse_ray, bounds))
-        return std::nullopt;
-
-    // Compute the surface interaction with the current primitive.
-    if (Option<SurfaceInteraction> interaction =
-            mPrimitive->intersect(inverse_ray, bounds)) {
-        interaction->p = object_to_world(interaction->p);
-        interaction->n = (object_to_world(interaction->n)).normalize();
-        interaction->mat = mPrimitive->material();
-
-        return interaction;
-    }
+    return mPrimitive->intersectWorld(ray, bounds);
+}
 
-    return std::nullopt;
+bool BVHPrim::occluded(
+    const Ray& ray, const TraversalRay& traversal_ray, const Interval& bounds
+) const {
+    return mPrimitive->occludedWorld(ray, bounds);
 }
 
 AABB BVHPrim::aabb() const {
     return mPrimitive->objectToWorld()(mPrimitive->aabb());
 }
 
+f64 BVHPrim::sahCost(const SAHParams& params) const {
+    return sah::leafCost(1, params) * aabb().surfaceArea();
+}
+
 BVHBranch::BVHBranch(const BVHNodePtr& left, const BVHNodePtr& right)
     : mLeft(left), mRight(right), mBbox(left->aabb().enclosure(right->aabb())) {
 }
 
 Option<SurfaceInteraction> BVHBranch::intersect(
-    const Ray& ray, const Interval& bounds
+    const Ray& ray, const TraversalRay& traversal_ray, const Interval& bounds
 ) const {
-    if (!mBbox.checkIntersect(ray, bounds))
+    if (!mBbox.checkIntersect(traversal_ray, bounds))
         return std::nullopt;
 
-    const Option<SurfaceInteraction> si1 = mLeft->intersect(ray, bounds);
-    const Option<SurfaceInteraction> si2 =
-        mRight->intersect(ray, Interval(bounds.min, si1 ? si1->t : bounds.max));
+    const Option<SurfaceInteraction> si1 =
+        mLeft->intersect(ray, traversal_ray, bounds);
+    const Option<SurfaceInteraction> si2 = mRight->intersect(
+        ray, traversal_ray, Interval(bounds.min, si1 ? si1->t : bounds.max)
+    );
 
     if (!si1)
         return si2;
@@ -56,57 +48,130 @@ Option<SurfaceInteraction> BVHBranch::intersect(
     return (si1->t < si2->t) ? si1 : si2;
 }
 
+bool BVHBranch::occluded(
+    const Ray& ray, const TraversalRay& traversal_ray, const Interval& bounds
+) const {
+    if (!mBbox.checkIntersect(traversal_ray, bounds))
+        return false;
+
+    return mLeft->occluded(ray, traversal_ray, bounds) ||
+           mRight->occluded(ray, traversal_ray, bounds);
+}
+
 AABB BVHBranch::aabb() const {
     return mBbox;
 }
 
+f64 BVHBranch::sahCost(const SAHParams& params) const {
+    return params.traversalCost * mBbox.surfaceArea() +
+           mLeft->sahCost(params) + mRight->sahCost(params);
+}
+
 namespace {
 
-bool boxAxisCompare(
-    const PrimitivePtr& left, const PrimitivePtr& right, const u32 ax
-) {
+bool boxAxisCompare(const BuildRef& left, const BuildRef& right, const u32 ax) {
     assertm(ax < 3, "axis must be 0, 1, or 2");
-    return left->aabb().axis(ax).min < right->aabb().axis(ax).min;
+    return left.bbox.axis(ax).min < right.bbox.axis(ax).min;
 }
 
 };
 
-BVH::BVH() : mRoot(nullptr) {
+BVH::BVH() : BVH(SplitMethod::Median, SAHParams()) {
+}
+
+BVH::BVH(const SplitMethod method, const SAHParams& params)
+    : mSplitMethod(method), mParams(params), mRoot(nullptr) {
 }
 
 void BVH::build(const std::vector<PrimitivePtr>& prims) {
-    std::vector<PrimitivePtr> copy = prims;
-    mRoot = buildRecursive(std::span<PrimitivePtr>(copy));
+    if (prims.empty()) {
+        mRoot = nullptr;
+        return;
+    }
+
+    // Split decisions are made on the worldspace bounds of the primitives.
+    std::vector<BuildRef> refs;
+    refs.reserve(prims.size());
+    for (Index i = 0; i < prims.size(); ++i) {
+        const AABB bbox = prims[i]->objectToWorld()(prims[i]->aabb());
+        refs.push_back(BuildRef{bbox, bbox.centroid(), i});
+    }
+
+    mRoot = buildRecursive(prims, std::span<BuildRef>(refs));
 }
 
 Option<SurfaceInteraction> BVH::intersect(const Ray& ray) const {
+    if (!mRoot)
+        return std::nullopt;
+
     const Interval bounds(0.001, math::infinity<f64>());
-    return mRoot->intersect(ray, bounds);
+    return mRoot->intersect(ray, TraversalRay(ray), bounds);
 }
 
-BVHNodePtr BVH::buildRecursive(std::span<PrimitivePtr> prims) const {
-    if (prims.size() == 1)
-        return std::make_shared<BVHPrim>(prims.front());
+bool BVH::occluded(const Ray& ray, const f64 tmax) const {
+    if (!mRoot)
+        return false;
+
+    const Interval bounds(0.001, tmax);
+    return mRoot->occluded(ray, TraversalRay(ray), bounds);
+}
+
+f64 BVH::sahCost() const {
+    if (!mRoot)
+        return 0.0;
+
+    return mRoot->sahCost(mParams) / mRoot->aabb().surfaceArea();
+}
 
-    if (prims.size() == 2) {
-        BVHNodePtr left = std::make_shared<BVHPrim>(prims.front());
-        BVHNodePtr right = std::make_shared<BVHPrim>(prims.back());
+BVHNodePtr BVH::buildRecursive(
+    const std::vector<PrimitivePtr>& prims, std::span<BuildRef> refs
+) const {
+    if (refs.size() == 1)
+        return std::make_shared<BVHPrim>(prims[refs.front().index]);
+
+    if (refs.size() == 2) {
+        BVHNodePtr left = std::make_shared<BVHPrim>(prims[refs.front().index]);
+        BVHNodePtr right = std::make_shared<BVHPrim>(prims[refs.back().index]);
         return std::make_shared<BVHBranch>(left, right);
     }
 
     AABB total = AABB::empty;
-    for (const PrimitivePtr& prim : prims)
-        total = total.enclosure(prim->aabb());
-
-    const Index ax = total.longestAxis();
-    auto comparator = [ax](
-                          const PrimitivePtr& left, const PrimitivePtr& right
-                      ) { return boxAxisCompare(left, right, ax); };
+    AABB centroids = AABB::empty;
+    for (const BuildRef& ref : refs) {
+        total = total.enclosure(ref.bbox);
+        centroids = centroids.enclosure(AABB(ref.centroid, ref.centroid));
+    }
 
-    std::sort(std::begin(prims), std::end(prims), comparator);
+    Index middle = 0;
+
+    switch (mSplitMethod) {
+    case SplitMethod::Median:
+        middle = partitionMedian(refs, total);
+        break;
+    case SplitMethod::SAH:
+        // Fall back to the median split if the centroids cannot be binned.
+        if (const Option<sah::Split> split =
+                sah::findSplit(refs, total, centroids, mParams))
+            middle = sah::partition(refs, centroids, *split, mParams.binCount);
+        else
+            middle = partitionMedian(refs, total);
+        break;
+    default:
+        unreachable;
+    }
 
-    const Index middle = prims.size() / 2;
-    BVHNodePtr left = buildRecursive(prims.subspan(0, middle));
-    BVHNodePtr right = buildRecursive(prims.subspan(middle));
+    BVHNodePtr left = buildRecursive(prims, refs.subspan(0, middle));
+    BVHNodePtr right = buildRecursive(prims, refs.subspan(middle));
     return std::make_shared<BVHBranch>(left, right);
 }
+
+Index BVH::partitionMedian(std::span<BuildRef> refs, const AABB& bbox) const {
+    const Index ax = bbox.longestAxis();
+    auto comparator = [ax](const BuildRef& left, const BuildRef& right) {
+        return boxAxisCompare(left, right, ax);
+    };
+
+    std::sort(std::begin(refs), std::end(refs), comparator);
+
+    return refs.size() / 2;
+}
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <span>
+
+#include "common/math/traversal_ray.hpp"
 #include "common/prelude.hpp"
 #include "primitive/primitive.hpp"
+#include "render/accel/sah.hpp"
 #include "render/spatial_structure.hpp"
 
 /// @brief Generic BVH node.
@@ -11,13 +15,28 @@ public:
     virtual ~BVHNode() = default;
 
     /// @brief Computes the intersection with the subtree rooted at this node.
-    /// Checks the intersection with the AABB before traversal.
+    /// Checks the intersection with the AABB before traversal, using the
+    /// traversal form of the ray prepared once per ray.
     virtual Option<SurfaceInteraction> intersect(
-        const Ray& ray, const Interval& bounds
+        const Ray& ray,
+        const TraversalRay& traversal_ray,
+        const Interval& bounds
+    ) const = 0;
+
+    /// @brief Determines whether the ray hits any primitive in the subtree
+    /// rooted at this node within the parameter bounds.
+    virtual bool occluded(
+        const Ray& ray,
+        const TraversalRay& traversal_ray,
+        const Interval& bounds
     ) const = 0;
 
     /// @brief Retrieves the AABB of this BVH subtree.
     virtual AABB aabb() const = 0;
+
+    /// @brief Computes the SAH cost of this subtree, weighted by surface area
+    /// but not normalized by the surface area of the root.
+    virtual f64 sahCost(const SAHParams& params) const = 0;
 };
 
 using BVHNodePtr = std::shared_ptr<BVHNode>;
@@ -29,11 +48,21 @@ public:
     ~BVHPrim() override = default;
 
     Option<SurfaceInteraction> intersect(
-        const Ray& ray, const Interval& bounds
+        const Ray& ray,
+        const TraversalRay& traversal_ray,
+        const Interval& bounds
+    ) const override;
+
+    bool occluded(
+        const Ray& ray,
+        const TraversalRay& traversal_ray,
+        const Interval& bounds
     ) const override;
 
     AABB aabb() const override;
 
+    f64 sahCost(const SAHParams& params) const override;
+
 private:
     PrimitivePtr mPrimitive;
 };
@@ -45,11 +74,21 @@ public:
     ~BVHBranch() override = default;
 
     virtual Option<SurfaceInteraction> intersect(
-        const Ray& ray, const Interval& bounds
+        const Ray& ray,
+        const TraversalRay& traversal_ray,
+        const Interval& bounds
+    ) const override;
+
+    bool occluded(
+        const Ray& ray,
+        const TraversalRay& traversal_ray,
+        const Interval& bounds
     ) const override;
 
     AABB aabb() const override;
 
+    f64 sahCost(const SAHParams& params) const override;
+
 private:
     BVHNodePtr mLeft;
     BVHNodePtr mRight;
@@ -59,16 +98,41 @@ private:
 /// @brief Bounding Volume Hierarchy (BVH) spatial acceleration structure.
 class BVH : public SpatialStructure {
 public:
+    /// @brief Strategy used to partition primitives at each branch.
+    enum class SplitMethod {
+        /// @brief Splits at the median primitive along the longest axis.
+        Median = 0,
+        /// @brief Splits at the lowest cost binned surface area heuristic
+        /// partition.
+        SAH,
+    };
+
     BVH();
+    BVH(const SplitMethod method, const SAHParams& params);
     ~BVH() override = default;
 
     void build(const std::vector<PrimitivePtr>& prims) override;
 
     Option<SurfaceInteraction> intersect(const Ray& ray) const override;
 
+    bool occluded(const Ray& ray, const f64 tmax) const override;
+
+    /// @brief Computes the SAH cost of the built tree, normalized by the
+    /// surface area of the root. Lower is better.
+    f64 sahCost() const;
+
 private:
     /// @brief Recursively constructs the BVH tree.
-    BVHNodePtr buildRecursive(std::span<PrimitivePtr> prims) const;
+    BVHNodePtr buildRecursive(
+        const std::vector<PrimitivePtr>& prims, std::span<BuildRef> refs
+    ) const;
+
+    /// @brief Partitions the references at the median along the longest axis
+    /// of the bounds.
+    /// @returns The number of references placed on the left side.
+    Index partitionMedian(std::span<BuildRef> refs, const AABB& bbox) const;
 
+    SplitMethod mSplitMethod;
+    SAHParams mParams;
     BVHNodePtr mRoot;
 };
@@ -2,7 +2,6 @@
 
 #include "common/math/numeric.hpp"
 #include "common/util/log.hpp"
-#include "common/util/thread_random.hpp"
 
 Camera::Camera(
     const Point3D& look_from,
@@ -40,14 +39,24 @@ Camera::Camera(
                    0.5 * (mPixelU + mPixelV);
 }
 
-const Point3D& Camera::origin() const {
-    return mOrigin;
+Camera::Camera(BinaryReader& reader) {
+    mNx = reader.read<u32>();
+    mNy = reader.read<u32>();
+    mViewWidth = reader.read<f64>();
+    mViewHeight = reader.read<f64>();
+
+    mOrigin = reader.readXYZ<Point3D>();
+    mU = reader.readXYZ<Vector3D>();
+    mV = reader.readXYZ<Vector3D>();
+    mW = reader.readXYZ<Vector3D>();
+
+    mPixelOrigin = reader.readXYZ<Point3D>();
+    mPixelU = reader.readXYZ<Vector3D>();
+    mPixelV = reader.readXYZ<Vector3D>();
 }
 
-static inline Vector2D sample_unit_square() {
-    return Vector2D(
-        thread_rng::uniform(-0.5, 0.5), thread_rng::uniform(-0.5, 0.5)
-    );
+const Point3D& Camera::origin() const {
+    return mOrigin;
 }
 
 Point3D Camera::p(const Index px, const Index py) const {
@@ -60,14 +69,14 @@ Point3D Camera::p(const Index px, const Index py) const {
     return mPixelOrigin + x * mPixelU + y * mPixelV;
 }
 
-Point3D Camera::sample(const Index px, const Index py) const {
+Point3D Camera::sample(
+    const Index px, const Index py, const Vector2D& u
+) const {
     assertm(px < mNx, "px must be less than raster width");
     assertm(py < mNy, "py must be less than raster height");
 
-    const Vector2D sample_pos = sample_unit_square();
-
-    const f64 x = static_cast<f64>(px) + sample_pos.x;
-    const f64 y = static_cast<f64>(py) + sample_pos.y;
+    const f64 x = static_cast<f64>(px) + u.x - 0.5;
+    const f64 y = static_cast<f64>(py) + u.y - 0.5;
 
     return mPixelOrigin + x * mPixelU + y * mPixelV;
 }
@@ -79,3 +88,19 @@ Size Camera::nx() const {
 Size Camera::ny() const {
     return mNy;
 }
+
+void Camera::save(BinaryWriter& writer) const {
+    writer.write(mNx);
+    writer.write(mNy);
+    writer.write(mViewWidth);
+    writer.write(mViewHeight);
+
+    writer.writeXYZ(mOrigin);
+    writer.writeXYZ(mU);
+    writer.writeXYZ(mV);
+    writer.writeXYZ(mW);
+
+    writer.writeXYZ(mPixelOrigin);
+    writer.writeXYZ(mPixelU);
+    writer.writeXYZ(mPixelV);
+}
@@ -3,6 +3,7 @@
 #include "common/math/point.hpp"
 #include "common/math/vector.hpp"
 #include "common/prelude.hpp"
+#include "common/util/binary_io.hpp"
 
 /// @brief Virtual camera class. Defines a camera frame using a
 /// lookfrom-lookat-fov parameterization. Provides pixel-to-worldspace
@@ -17,6 +18,10 @@ public:
         const Size nx,
         const Size ny
     );
+
+    /// @brief Creates the camera written by save().
+    /// @throws std::runtime_error if the data is truncated.
+    explicit Camera(BinaryReader& reader);
     ~Camera() = default;
 
     /// @brief Camera origin (equal to LookFrom).
@@ -26,9 +31,9 @@ public:
     /// position corresponds to the center of the pixel.
     Point3D p(const Index px, const Index py) const;
 
-    /// @brief Samples the pixel (px, py). The position corresponds to the
-    /// center of the pixel.
-    Point3D sample(const Index px, const Index py) const;
+    /// @brief Samples the pixel (px, py). The position is offset from the
+    /// center of the pixel by `u - 0.5`, where `u` is a 2D sample in [0, 1)^2.
+    Point3D sample(const Index px, const Index py, const Vector2D& u) const;
 
     /// @brief Retrieves the raster width of the camera view.
     Size nx() const;
@@ -36,6 +41,10 @@ public:
     /// @brief Retrieves the raster height of the camera view.
     Size ny() const;
 
+    /// @brief Writes the camera frame and raster, so that the camera can be
+    /// recreated exactly.
+    void save(BinaryWriter& writer) const;
+
 private:
     u32 mNx, mNy;
     f64 mViewWidth, mViewHeight;
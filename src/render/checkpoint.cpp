@@ -0,0 +1,102 @@
+#include "render/checkpoint.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "common/util/binary_io.hpp"
+#include "common/util/hash.hpp"
+#include "common/util/mapped_file.hpp"
+
+namespace {
+
+constexpr u32 cMagic = 0x4b434c47;  // "GLCK"
+constexpr u32 cVersion = 2;
+
+}
+
+void Checkpoint::save(const char* path) const {
+    BinaryWriter writer(path);
+
+    writer.write(cMagic);
+    writer.write(cVersion);
+    writer.write(configHash);
+    writer.write<u64>(framebuffer.width());
+    writer.write<u64>(framebuffer.height());
+    writer.write<u64>(nextSample);
+
+    for (Index j = 0; j < framebuffer.height(); ++j) {
+        for (Index i = 0; i < framebuffer.width(); ++i) {
+            const Vector3D sum = framebuffer.sum(i, j);
+            writer.write(sum.x);
+            writer.write(sum.y);
+            writer.write(sum.z);
+            writer.write<u64>(framebuffer.count(i, j));
+        }
+    }
+
+    writer.commit();
+}
+
+Checkpoint Checkpoint::load(const char* path) {
+    const MappedFile file(path);
+    BinaryReader reader(file.bytes());
+
+    if (reader.read<u32>() != cMagic)
+        throw std::runtime_error("not a checkpoint: " + std::string(path));
+    if (reader.read<u32>() != cVersion)
+        throw std::runtime_error(
+            "unsupported checkpoint version: " + std::string(path)
+        );
+
+    const u64 config_hash = reader.read<u64>();
+    const Size width = reader.read<u64>();
+    const Size height = reader.read<u64>();
+    const Size next_sample = reader.read<u64>();
+
+    // Each pixel holds three doubles and a count.
+    if (width * height > reader.remaining() / (4 * sizeof(u64)))
+        throw std::runtime_error("truncated checkpoint: " + std::string(path));
+
+    Checkpoint checkpoint{config_hash, next_sample, Framebuffer(width, height)};
+
+    for (Index j = 0; j < height; ++j) {
+        for (Index i = 0; i < width; ++i) {
+            const f64 x = reader.read<f64>();
+            const f64 y = reader.read<f64>();
+            const f64 z = reader.read<f64>();
+            const Size count = reader.read<u64>();
+            checkpoint.framebuffer.add(i, j, Vector3D(x, y, z), count);
+        }
+    }
+
+    return checkpoint;
+}
+
+u64 Checkpoint::hashConfig(
+    const Config& config, const Camera& camera, const u64 scene_hash
+) {
+    Hasher hasher;
+    hasher.add(scene_hash);
+    hasher.add<u64>(camera.nx());
+    hasher.add<u64>(camera.ny());
+
+    // The origin and the centers of three pixels fix the view, as pixel
+    // centers are affine in the pixel coordinates.
+    const Point3D points[] = {
+        camera.origin(), camera.p(0, 0), camera.p(1, 0), camera.p(0, 1)
+    };
+    for (const Point3D& point : points) {
+        hasher.add(point.x);
+        hasher.add(point.y);
+        hasher.add(point.z);
+    }
+
+    hasher.add(config.renderingMode);
+    hasher.add(config.samplingKind);
+    hasher.add(config.integratorKind);
+    hasher.add(config.samplesPerPixel);
+    hasher.add(config.traceDepth);
+    hasher.add(config.rouletteDepth);
+    hasher.add(config.seed);
+    return hasher.value();
+}
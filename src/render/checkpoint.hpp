@@ -0,0 +1,40 @@
+#pragma once
+
+#include "common/prelude.hpp"
+#include "common/util/framebuffer.hpp"
+#include "render/camera.hpp"
+#include "render/config.hpp"
+
+/// @brief Snapshot of an unfinished render that can be written to disk and
+/// resumed later.
+///
+/// The file stores, in native byte order, a magic number and format version,
+/// a hash of the image-affecting configuration, camera and scene, the image
+/// size, the index of the next pixel sample, and for every pixel the
+/// accumulated color sum in double precision followed by its sample count.
+/// Samplers derive their sequences from the pixel and sample index, so the
+/// next sample index is all that is needed to continue the random sequences.
+struct Checkpoint {
+    u64 configHash;
+    Size nextSample;
+    Framebuffer framebuffer;
+
+    /// @brief Writes the checkpoint to the path. The file is written to a
+    /// temporary path first and then renamed, so that a crash during the
+    /// write leaves the previous checkpoint intact.
+    /// @throws std::runtime_error if the file cannot be written.
+    void save(const char* path) const;
+
+    /// @brief Reads a checkpoint from the path.
+    /// @throws std::runtime_error if the file cannot be read or is not a
+    /// valid checkpoint.
+    static Checkpoint load(const char* path);
+
+    /// @brief Hashes the configuration fields that change the rendered image,
+    /// together with the camera view and the hash of the scene content.
+    /// Fields that only change how the work is scheduled, such as the thread
+    /// count or the pass size, are excluded.
+    static u64 hashConfig(
+        const Config& config, const Camera& camera, const u64 scene_hash
+    );
+};
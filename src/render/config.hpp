@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "common/prelude.hpp"
 #include "common/util/format.hpp"
 
@@ -11,19 +14,107 @@ enum class RenderingMode {
 enum class SamplingKind {
     Center = 0,
     UniformRandom,
+    Stratified,
+    Sobol,
+    PMJ02,
+};
+
+enum class IntegratorKind {
+    Recursive = 0,
+    Iterative,
+    NextEvent,
 };
 
 enum class SpatialKind {
     PrimList = 0,
     BVH,
+    BVHSAH,
+    LinearBVH,
+    WideBVH,
 };
 
 struct Config {
     RenderingMode renderingMode = RenderingMode::Full;
     SamplingKind samplingKind = SamplingKind::UniformRandom;
     SpatialKind spatialKind = SpatialKind::BVH;
+    IntegratorKind integratorKind = IntegratorKind::Recursive;
     u64 samplesPerPixel = 100;
     u64 traceDepth = 50;
+
+    // Depth after which the iterative and next event integrators terminate
+    // paths with Russian roulette.
+    u64 rouletteDepth = 3;
+
+    // Adaptive sampling. A positive threshold on the relative error of the
+    // pixel luminance replaces samplesPerPixel with [minSpp, maxSpp]. An
+    // optional heatmap of the samples taken per pixel is saved to
+    // sppHeatmapPath.
+    f64 adaptiveThreshold = 0.0;
+    u64 minSpp = 16;
+    u64 maxSpp = 1024;
+    std::string sppHeatmapPath;
+
+    // Progressive rendering. The image is refined in passes of passSpp
+    // samples per pixel (0 renders a single pass) until samplesPerPixel is
+    // reached or the next pass would exceed timeBudgetSeconds (0 for no
+    // budget). Between passes, the image so far is saved to snapshotPath at
+    // most every snapshotIntervalSeconds. Passes take the same samples as a
+    // single pass, but sum them in another order, so the two agree up to
+    // floating-point rounding.
+    u64 passSpp = 0;
+    f64 timeBudgetSeconds = 0.0;
+    std::string snapshotPath;
+    f64 snapshotIntervalSeconds = 10.0;
+
+    // Checkpoints. Between progressive passes, the accumulated samples are
+    // saved to checkpointPath at most every checkpointIntervalSeconds, and
+    // once more when the render stops. Without a pass size, renders with a
+    // checkpoint path take one sample per pixel per pass. A render started
+    // with resumeFrom set to a checkpoint of the same configuration, camera
+    // and scene continues from it. Adaptive renders do not write or resume
+    // checkpoints.
+    std::string checkpointPath;
+    f64 checkpointIntervalSeconds = 300.0;
+    std::string resumeFrom;
+
+    // Random seed. Renders with the same seed are identical regardless of
+    // the thread count and tile order.
+    u64 seed = 0;
+
+    // Worker processes. A positive count forks that many single-threaded
+    // workers, which render tiles and send them back over local sockets, and
+    // every "host:port" of workerAddresses adds a remote worker started with
+    // `Glacier --worker host:port`. Without workers, the image is rendered
+    // with threads in this process. Every worker receives a snapshot of the
+    // built scene, the camera and the options it renders with, so all hosts
+    // must share the byte order of this one. Adaptive sampling, progressive
+    // passes and checkpoints are not supported with workers.
+    u64 workers = 0;
+    std::vector<std::string> workerAddresses;
+
+    // Render threads. 0 uses std::thread::hardware_concurrency().
+    u64 threads = 0;
+    u64 tileSize = 16;
+
+    // Primary ray packets. When set, uniform renders trace the camera rays
+    // of blocks of 8x8 pixels together through spatial structures that
+    // support packets, which is LinearBVH. Rays after the first bounce are
+    // traced one at a time, and the image is the same either way.
+    bool packetTracing = false;
+
+    // Directory of binary scene snapshots. When set, the acceleration data
+    // built for the scene is saved there and reused by later renders of the
+    // same geometry, such as the frames of a camera turntable. Only the
+    // acceleration builds are skipped: the scene script still runs and its
+    // meshes are still read.
+    std::string sceneCacheDir;
+
+    // Binned SAH parameters. Used by SpatialKind::BVHSAH, LinearBVH and
+    // WideBVH. There must be at least 2 bins, the traversal cost must not be
+    // negative and the intersection cost must be positive.
+    u64 sahBinCount = 12;
+    f64 sahTraversalCost = 0.125;
+    f64 sahIntersectionCost = 1.0;
 };
 
 template <>
@@ -36,6 +127,15 @@ struct FormatWriter<SamplingKind> {
         case SamplingKind::UniformRandom:
             sb.append("UniformRandom");
             break;
+        case SamplingKind::Stratified:
+            sb.append("Stratified");
+            break;
+        case SamplingKind::Sobol:
+            sb.append("Sobol");
+            break;
+        case SamplingKind::PMJ02:
+            sb.append("PMJ02");
+            break;
         default:
             unreachable;
         }
@@ -58,6 +158,25 @@ struct FormatWriter<RenderingMode> {
     }
 };
 
+template <>
+struct FormatWriter<IntegratorKind> {
+    static void write(const IntegratorKind& kind, StringBuffer& sb) {
+        switch (kind) {
+        case IntegratorKind::Recursive:
+            sb.append("Recursive");
+            break;
+        case IntegratorKind::Iterative:
+            sb.append("Iterative");
+            break;
+        case IntegratorKind::NextEvent:
+            sb.append("NextEvent");
+            break;
+        default:
+            unreachable;
+        }
+    }
+};
+
 template <>
 struct FormatWriter<SpatialKind> {
     static void write(const SpatialKind& mode, StringBuffer& sb) {
@@ -68,6 +187,15 @@ struct FormatWriter<SpatialKind> {
         case SpatialKind::BVH:
             sb.append("BVH");
             break;
+        case SpatialKind::BVHSAH:
+            sb.append("BVHSAH");
+            break;
+        case SpatialKind::LinearBVH:
+            sb.append("LinearBVH");
+            break;
+        case SpatialKind::WideBVH:
+            sb.append("WideBVH");
+            break;
         default:
             unreachable;
         }
@@ -0,0 +1,113 @@
+#include "light_list.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "render/material/emissive.hpp"
+
+namespace {
+
+/// @brief Computes the determinant of the linear part of the transform.
+f64 linearDeterminant(const Transform& transform) {
+    const Matrix4D& m = transform.matrix();
+    return m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1)) -
+           m(0, 1) * (m(1, 0) * m(2, 2) - m(1, 2) * m(2, 0)) +
+           m(0, 2) * (m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0));
+}
+
+}
+
+LightList::LightList() : mLights(), mCdf(), mIndices() {
+}
+
+void LightList::build(const std::vector<PrimitivePtr>& prims) {
+    mLights.clear();
+    mCdf.clear();
+    mIndices.clear();
+
+    f64 total = 0.0;
+
+    for (const PrimitivePtr& prim : prims) {
+        const MaterialPtr& mat = prim->material();
+        if (!mat || mat->kind() != Material::Kind::Emissive)
+            continue;
+
+        const f64 area = prim->area();
+        if (area <= 0.0)
+            continue;
+
+        const f64 determinant =
+            math::abs(linearDeterminant(prim->objectToWorld()));
+        if (determinant <= 0.0)
+            continue;
+
+        const Emissive* emissive = static_cast<const Emissive*>(mat.get());
+
+        mIndices[prim.get()] = mLights.size();
+        mLights.push_back(Light{prim, emissive->emitted(), area, determinant});
+
+        // Selection weight. Exact worldspace area under uniform scaling.
+        total += area * std::cbrt(determinant * determinant);
+        mCdf.push_back(total);
+    }
+
+    for (f64& value : mCdf)
+        value /= total;
+}
+
+bool LightList::empty() const {
+    return mLights.empty();
+}
+
+Size LightList::size() const {
+    return mLights.size();
+}
+
+Option<LightSample> LightList::sample(
+    const f64 u0, const f64 u1, const f64 u2
+) const {
+    if (mLights.empty())
+        return std::nullopt;
+
+    const auto it = std::upper_bound(std::begin(mCdf), std::end(mCdf), u0);
+    const Index index = std::min<Index>(
+        std::distance(std::begin(mCdf), it), mLights.size() - 1
+    );
+    const Light& light = mLights[index];
+
+    const Option<SurfaceSample> sample = light.primitive->sample(u1, u2);
+    if (!sample)
+        return std::nullopt;
+
+    const Transform& transform = light.primitive->objectToWorld();
+    const Normal3D n = transform(sample->n).normalize();
+
+    const f64 pmf = mCdf[index] - ((index == 0) ? 0.0 : mCdf[index - 1]);
+    const f64 pdf = pmf / (light.area * areaScale(light, n));
+
+    return LightSample{transform(sample->p), n, light.radiance, pdf};
+}
+
+f64 LightList::pdf(const Primitive* prim, const Normal3D& n) const {
+    const auto it = mIndices.find(prim);
+    if (it == std::end(mIndices))
+        return 0.0;
+
+    const Index index = it->second;
+    const Light& light = mLights[index];
+
+    const f64 pmf = mCdf[index] - ((index == 0) ? 0.0 : mCdf[index - 1]);
+    return pmf / (light.area * areaScale(light, n));
+}
+
+f64 LightList::areaScale(const Light& light, const Normal3D& n) {
+    if (light.primitive->hasIdentityTransform())
+        return 1.0;
+
+    // A surface element with object space normal m maps to one with area
+    // scaled by |det M| |M^-T m|. In terms of the unit worldspace normal n this
+    // is |det M| / |M^T n|, and the world to object transform applies M^T to
+    // normals.
+    const f64 length = light.primitive->worldToObject()(n).length();
+    return light.determinant / length;
+}
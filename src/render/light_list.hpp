@@ -0,0 +1,67 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "common/math/normal.hpp"
+#include "common/math/point.hpp"
+#include "common/math/vector.hpp"
+#include "common/prelude.hpp"
+#include "render/primitive/primitive.hpp"
+
+/// @brief Point sampled on an emitter.
+struct LightSample {
+    Point3D p;
+    Normal3D n;
+    Vector3D radiance;
+
+    // Density of the sample with respect to worldspace area.
+    f64 pdf;
+};
+
+/// @brief List of the emissive primitives in the scene. Emitters are selected
+/// proportionally to their area and sampled uniformly over their surface, so
+/// the density is close to uniform over the total emitting area.
+class LightList {
+public:
+    LightList();
+    ~LightList() = default;
+
+    /// @brief Collects the primitives with an emissive material that can be
+    /// sampled by area.
+    void build(const std::vector<PrimitivePtr>& prims);
+
+    /// @brief Determines whether the list has no emitters.
+    bool empty() const;
+
+    /// @brief Retrieves the number of emitters.
+    Size size() const;
+
+    /// @brief Samples a point on an emitter from the canonical random numbers
+    /// (u0, u1, u2). u0 selects the emitter and (u1, u2) the point.
+    Option<LightSample> sample(const f64 u0, const f64 u1, const f64 u2) const;
+
+    /// @brief Computes the worldspace area density with which `sample` would
+    /// have produced a point with unit worldspace normal `n` on `prim`. Zero if
+    /// the primitive is not in the list.
+    f64 pdf(const Primitive* prim, const Normal3D& n) const;
+
+private:
+    struct Light {
+        PrimitivePtr primitive;
+        Vector3D radiance;
+        f64 area;
+
+        // Absolute determinant of the linear part of the object to world
+        // transform.
+        f64 determinant;
+    };
+
+    /// @brief Computes the ratio of worldspace to object space area at a point
+    /// with unit worldspace normal `n` on the light.
+    static f64 areaScale(const Light& light, const Normal3D& n);
+
+    std::vector<Light> mLights;
+    std::vector<f64> mCdf;
+    std::unordered_map<const Primitive*, Index> mIndices;
+};
@@ -0,0 +1,111 @@
+#include "linear_bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+LinearBVH::LinearBVH() : LinearBVH(SAHParams()) {
+}
+
+LinearBVH::LinearBVH(const SAHParams& params)
+    : mParams(params), mTree(), mPrimitives() {
+}
+
+void LinearBVH::build(const std::vector<PrimitivePtr>& prims) {
+    mPrimitives = prims;
+
+    std::vector<BuildRef> refs;
+    refs.reserve(prims.size());
+    for (Index i = 0; i < prims.size(); ++i) {
+        const AABB bbox = prims[i]->objectToWorld()(prims[i]->aabb());
+        refs.push_back(BuildRef{bbox, bbox.centroid(), i});
+    }
+
+    mTree.build(std::move(refs), mParams, MAX_LEAF_SIZE);
+}
+
+void LinearBVH::save(BinaryWriter& writer) const {
+    mTree.save(writer);
+}
+
+void LinearBVH::load(
+    const std::vector<PrimitivePtr>& prims, BinaryReader& reader
+) {
+    mTree.load(reader);
+
+    for (const Index item : mTree.items())
+        if (item >= prims.size())
+            throw std::runtime_error("BVH references a missing primitive");
+
+    mPrimitives = prims;
+}
+
+Option<SurfaceInteraction> LinearBVH::intersect(const Ray& ray) const {
+    Option<SurfaceInteraction> closest = std::nullopt;
+    Interval bounds(0.001, math::infinity<f64>());
+
+    mTree.traverse(ray, bounds, [&](const Index item, Interval& bounds) {
+        Option<SurfaceInteraction> interaction =
+            mPrimitives[item]->intersectWorld(ray, bounds);
+        if (!interaction)
+            return false;
+
+        closest = std::move(interaction);
+        bounds.max = closest->t;
+        return true;
+    });
+
+    return closest;
+}
+
+bool LinearBVH::occluded(const Ray& ray, const f64 tmax) const {
+    const Interval bounds(0.001, tmax);
+
+    return mTree.traverseAny(ray, bounds, [&](const Index item) {
+        return mPrimitives[item]->occludedWorld(ray, bounds);
+    });
+}
+
+void LinearBVH::intersectPacket(
+    std::span<const Ray> rays, std::span<Option<SurfaceInteraction>> hits
+) const {
+    assertm(rays.size() == hits.size(), "packet hits do not match rays");
+
+    for (Index start = 0; start < rays.size(); start += BVHTree::MAX_PACKET) {
+        const Size count = std::min(BVHTree::MAX_PACKET, rays.size() - start);
+        const std::span<const Ray> packet = rays.subspan(start, count);
+        const std::span<Option<SurfaceInteraction>> packet_hits =
+            hits.subspan(start, count);
+
+        for (Option<SurfaceInteraction>& hit : packet_hits)
+            hit = std::nullopt;
+
+        std::array<Interval, BVHTree::MAX_PACKET> packet_bounds;
+        const std::span<Interval> bounds =
+            std::span(packet_bounds).first(count);
+        std::fill(
+            bounds.begin(), bounds.end(), Interval(0.001, math::infinity<f64>())
+        );
+        const u64 mask = (count == BVHTree::MAX_PACKET)
+                             ? ~u64(0)
+                             : (u64(1) << count) - 1;
+
+        mTree.traversePacket(
+            packet,
+            mask,
+            bounds,
+            [&](const LinearBVHNode& leaf, const u64 leaf_mask) {
+                for (Index i = 0; i < leaf.itemCount; ++i) {
+                    const Index item = mTree.items()[leaf.itemOffset + i];
+                    mPrimitives[item]->intersectWorldPacket(
+                        packet, leaf_mask, bounds, packet_hits
+                    );
+                }
+            }
+        );
+    }
+}
+
+f64 LinearBVH::sahCost() const {
+    return mTree.sahCost(mParams);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common/prelude.hpp"
+#include "render/accel/bvh_tree.hpp"
+#include "render/spatial_structure.hpp"
+
+/// @brief Flattened BVH spatial acceleration structure. Primitives are stored
+/// in a contiguous array of 32-byte nodes in depth-first order, which avoids
+/// the pointer chasing and virtual dispatch of BVH.
+class LinearBVH : public SpatialStructure {
+public:
+    LinearBVH();
+    explicit LinearBVH(const SAHParams& params);
+    ~LinearBVH() override = default;
+
+    void build(const std::vector<PrimitivePtr>& prims) override;
+
+    Option<SurfaceInteraction> intersect(const Ray& ray) const override;
+
+    bool occluded(const Ray& ray, const f64 tmax) const override;
+
+    /// @brief Traverses the tree once for every MAX_PACKET rays, testing each
+    /// primitive against the rays that enter its leaf at once.
+    void intersectPacket(
+        std::span<const Ray> rays, std::span<Option<SurfaceInteraction>> hits
+    ) const override;
+
+    /// @brief Writes the built tree. The primitives are not written.
+    void save(BinaryWriter& writer) const;
+
+    /// @brief Adopts the primitives with a tree written by save() over the
+    /// same primitives, instead of building it.
+    /// @throws std::runtime_error if the tree does not match the primitives.
+    void load(const std::vector<PrimitivePtr>& prims, BinaryReader& reader);
+
+    /// @brief Computes the SAH cost of the built tree, normalized by the
+    /// surface area of the root. Lower is better.
+    f64 sahCost() const;
+
+private:
+    /// @brief Maximum number of primitives in a leaf.
+    static constexpr Size MAX_LEAF_SIZE = 4;
+
+    SAHParams mParams;
+    BVHTree mTree;
+    std::vector<PrimitivePtr> mPrimitives;
+};
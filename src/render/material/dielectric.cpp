@@ -1,7 +1,7 @@
 #include "dielectric.hpp"
 
 #include "common/math/vector_ops.hpp"
-#include "common/util/thread_random.hpp"
+#include "render/sampler/sampler.hpp"
 
 Dielectric::Dielectric(const f64 eta) : mEta(eta) {
     mKind = Kind::Dielectric;
@@ -14,7 +14,9 @@ static f64 reflectance(const f64 cosine, const f64 ri) {
 }
 
 Option<ScatterRecord> Dielectric::scatter(
-    const Ray& incident, const SurfaceInteraction& interaction
+    const Ray& incident,
+    const SurfaceInteraction& interaction,
+    Sampler& sampler
 ) const {
     static const Vector3D color = Vector3D::one();
 
@@ -29,7 +31,7 @@ Option<ScatterRecord> Dielectric::scatter(
 
     const bool cannot_refract = ri * sin_theta > 1.0;
     const bool schlick_test =
-        reflectance(cos_theta, ri) > thread_rng::uniform<f64>();
+        reflectance(cos_theta, ri) > sampler.get1D();
 
     const Vector3D direction = (cannot_refract || schlick_test)
                                    ? math::reflect(l, n)
@@ -39,3 +41,12 @@ Option<ScatterRecord> Dielectric::scatter(
 
     return ScatterRecord(scattered, color);
 }
+
+void Dielectric::save(BinaryWriter& writer) const {
+    Material::save(writer);
+    writer.write(mEta);
+}
+
+std::shared_ptr<Dielectric> Dielectric::load(BinaryReader& reader) {
+    return std::make_shared<Dielectric>(reader.read<f64>());
+}
@@ -11,9 +11,17 @@ public:
 
     /// @brief Scatters the incident ray via refraction.
     Option<ScatterRecord> scatter(
-        const Ray& incident, const SurfaceInteraction& interaction
+        const Ray& incident,
+        const SurfaceInteraction& interaction,
+        Sampler& sampler
     ) const override;
 
+    /// @brief Writes the kind and parameters of the material.
+    void save(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by save() after the kind.
+    static std::shared_ptr<Dielectric> load(BinaryReader& reader);
+
 private:
     f64 mEta;
 };
@@ -7,3 +7,12 @@ Emissive::Emissive(const Vector3D& color) : mColor(color) {
 Vector3D Emissive::emitted() const {
     return mColor;
 }
+
+void Emissive::save(BinaryWriter& writer) const {
+    Material::save(writer);
+    writer.writeXYZ(mColor);
+}
+
+std::shared_ptr<Emissive> Emissive::load(BinaryReader& reader) {
+    return std::make_shared<Emissive>(reader.readXYZ<Vector3D>());
+}
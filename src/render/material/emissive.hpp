@@ -11,6 +11,12 @@ public:
     /// @brief The emitted color of the light.
     Vector3D emitted() const;
 
+    /// @brief Writes the kind and parameters of the material.
+    void save(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by save() after the kind.
+    static std::shared_ptr<Emissive> load(BinaryReader& reader);
+
 private:
     Vector3D mColor;
 };
@@ -1,17 +1,22 @@
 #include "lambertian.hpp"
 
+#include <algorithm>
+
 #include "common/math/vector_ops.hpp"
-#include "common/util/thread_random.hpp"
+#include "render/sampler/sampler.hpp"
 
 Lambertian::Lambertian(const Vector3D& color) : Material(), mColor(color) {
     mKind = Kind::Lambertian;
 }
 
 Option<ScatterRecord> Lambertian::scatter(
-    const Ray& incident, const SurfaceInteraction& interaction
+    const Ray& incident,
+    const SurfaceInteraction& interaction,
+    Sampler& sampler
 ) const {
-    const f64 x1 = thread_rng::uniform<f64>();
-    const f64 x2 = thread_rng::uniform<f64>();
+    const Vector2D u = sampler.get2D();
+    const f64 x1 = u.x;
+    const f64 x2 = u.y;
 
     // Sample polar and azimuthal spherical coordinates.
     const f64 alpha = std::sqrt(std::acos(1.0 - x1));
@@ -26,3 +31,48 @@ Option<ScatterRecord> Lambertian::scatter(
 
     return ScatterRecord(scattered, mColor);
 }
+
+ScatterRecord Lambertian::scatterCosine(
+    const SurfaceInteraction& interaction, Sampler& sampler
+) const {
+    const Vector2D u = sampler.get2D();
+    const f64 x1 = u.x;
+    const f64 x2 = u.y;
+
+    // Sample the unit disk and project it up onto the hemisphere.
+    const f64 r = std::sqrt(x1);
+    const f64 phi = 2.0 * math::pi<f64>() * x2;
+    const f64 z = std::sqrt(std::max(0.0, 1.0 - x1));
+
+    // Construct an orthonormal basis around the normal.
+    const Vector3D n = Vector3D(interaction.n).normalize();
+    const Vector3D a = (math::abs(n.x) > 0.9) ? Vector3D(0.0, 1.0, 0.0)
+                                              : Vector3D(1.0, 0.0, 0.0);
+    const Vector3D t = n.cross(a).normalize();
+    const Vector3D b = n.cross(t);
+
+    const Vector3D direction =
+        r * std::cos(phi) * t + r * std::sin(phi) * b + z * n;
+
+    return ScatterRecord(Ray(interaction.p, direction), mColor);
+}
+
+f64 Lambertian::pdf(
+    const SurfaceInteraction& interaction, const Vector3D& direction
+) const {
+    const f64 cos_theta = Vector3D(interaction.n).normalize().dot(direction);
+    return std::max(0.0, cos_theta) * math::inv_pi<f64>();
+}
+
+const Vector3D& Lambertian::albedo() const {
+    return mColor;
+}
+
+void Lambertian::save(BinaryWriter& writer) const {
+    Material::save(writer);
+    writer.writeXYZ(mColor);
+}
+
+std::shared_ptr<Lambertian> Lambertian::load(BinaryReader& reader) {
+    return std::make_shared<Lambertian>(reader.readXYZ<Vector3D>());
+}
@@ -11,9 +11,34 @@ public:
     /// @brief Scatters the incident ray where the material appearance
     /// properties correspond to a cosine distributed diffuse material.
     Option<ScatterRecord> scatter(
-        const Ray& incident, const SurfaceInteraction& interaction
+        const Ray& incident,
+        const SurfaceInteraction& interaction,
+        Sampler& sampler
     ) const override;
 
+    /// @brief Scatters the incident ray in an exactly cosine weighted
+    /// direction about the surface normal, so the sampling density is given by
+    /// `pdf`. Used where the density must be known, such as multiple
+    /// importance sampling.
+    ScatterRecord scatterCosine(
+        const SurfaceInteraction& interaction, Sampler& sampler
+    ) const;
+
+    /// @brief Computes the solid angle density of sampling the unit
+    /// `direction` with `scatterCosine`.
+    f64 pdf(
+        const SurfaceInteraction& interaction, const Vector3D& direction
+    ) const;
+
+    /// @brief Retrieves the diffuse reflectance.
+    const Vector3D& albedo() const;
+
+    /// @brief Writes the kind and parameters of the material.
+    void save(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by save() after the kind.
+    static std::shared_ptr<Lambertian> load(BinaryReader& reader);
+
 private:
     Vector3D mColor;
 };
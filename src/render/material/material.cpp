@@ -1,10 +1,20 @@
 #include "material.hpp"
 
+#include <stdexcept>
+
+#include "dielectric.hpp"
+#include "emissive.hpp"
+#include "lambertian.hpp"
+#include "mirror_specular.hpp"
+#include "specular.hpp"
+
 Material::Material() : mKind(Material::Kind::Null) {
 }
 
 Option<ScatterRecord> Material::scatter(
-    const Ray& incident, const SurfaceInteraction& interaction
+    const Ray& incident,
+    const SurfaceInteraction& interaction,
+    Sampler& sampler
 ) const {
     return std::nullopt;
 }
@@ -12,3 +22,26 @@ Option<ScatterRecord> Material::scatter(
 Material::Kind Material::kind() const {
     return mKind;
 }
+
+void Material::save(BinaryWriter& writer) const {
+    writer.write(mKind);
+}
+
+std::shared_ptr<Material> Material::load(BinaryReader& reader) {
+    switch (reader.read<Kind>()) {
+    case Kind::Null:
+        return std::make_shared<Material>();
+    case Kind::Lambertian:
+        return Lambertian::load(reader);
+    case Kind::Specular:
+        return Specular::load(reader);
+    case Kind::MirrorSpecular:
+        return MirrorSpecular::load(reader);
+    case Kind::Dielectric:
+        return Dielectric::load(reader);
+    case Kind::Emissive:
+        return Emissive::load(reader);
+    default:
+        throw std::runtime_error("invalid material kind");
+    }
+}
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "common/math/vector.hpp"
+#include "common/util/binary_io.hpp"
 #include "scatter_record.hpp"
 #include "surface_interaction.hpp"
 
 struct SurfaceInteraction;
+class Sampler;
 
 /// @brief Material base class. Defines how rays are scattered or transmitted
 /// upon intersection with the geometry which the material is applied to.
@@ -23,14 +25,24 @@ public:
     virtual ~Material() = default;
 
     /// @brief Scatters the incident ray according to local surface geometry and
-    /// material appearance properties.
+    /// material appearance properties. Random numbers are drawn from
+    /// `sampler`.
     virtual Option<ScatterRecord> scatter(
-        const Ray& incident, const SurfaceInteraction& interaction
+        const Ray& incident,
+        const SurfaceInteraction& interaction,
+        Sampler& sampler
     ) const;
 
     /// @brief Retrieves the kind of the material.
     Kind kind() const;
 
+    /// @brief Writes the kind of the material followed by its parameters.
+    virtual void save(BinaryWriter& writer) const;
+
+    /// @brief Reads a material written by save().
+    /// @throws std::runtime_error if the data is not a valid material.
+    static std::shared_ptr<Material> load(BinaryReader& reader);
+
 protected:
     Kind mKind;
 };
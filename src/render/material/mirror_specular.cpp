@@ -7,7 +7,9 @@ MirrorSpecular::MirrorSpecular(const Vector3D& color) : mColor(color) {
 }
 
 Option<ScatterRecord> MirrorSpecular::scatter(
-    const Ray& incident, const SurfaceInteraction& interaction
+    const Ray& incident,
+    const SurfaceInteraction& interaction,
+    Sampler& sampler
 ) const {
     const Point3D& p = interaction.p;
     const Normal3D& n = interaction.n;
@@ -19,3 +21,12 @@ Option<ScatterRecord> MirrorSpecular::scatter(
 
     return ScatterRecord(scattered, mColor);
 }
+
+void MirrorSpecular::save(BinaryWriter& writer) const {
+    Material::save(writer);
+    writer.writeXYZ(mColor);
+}
+
+std::shared_ptr<MirrorSpecular> MirrorSpecular::load(BinaryReader& reader) {
+    return std::make_shared<MirrorSpecular>(reader.readXYZ<Vector3D>());
+}
@@ -11,9 +11,17 @@ public:
     /// @brief Scatters the incident ray where the material appearance
     /// properties correspond to a mirror reflector.
     Option<ScatterRecord> scatter(
-        const Ray& incident, const SurfaceInteraction& interaction
+        const Ray& incident,
+        const SurfaceInteraction& interaction,
+        Sampler& sampler
     ) const override;
 
+    /// @brief Writes the kind and parameters of the material.
+    void save(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by save() after the kind.
+    static std::shared_ptr<MirrorSpecular> load(BinaryReader& reader);
+
 private:
     Vector3D mColor;
 };
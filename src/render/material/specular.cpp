@@ -1,7 +1,7 @@
 #include "specular.hpp"
 
 #include "common/math/vector_ops.hpp"
-#include "common/util/thread_random.hpp"
+#include "render/sampler/sampler.hpp"
 
 Specular::Specular(const Vector3D& color, const f64 phong)
     : mColor(color), mPhong(phong) {
@@ -9,10 +9,13 @@ Specular::Specular(const Vector3D& color, const f64 phong)
 }
 
 Option<ScatterRecord> Specular::scatter(
-    const Ray& incident, const SurfaceInteraction& interaction
+    const Ray& incident,
+    const SurfaceInteraction& interaction,
+    Sampler& sampler
 ) const {
-    const f64 x1 = thread_rng::uniform<f64>();
-    const f64 x2 = thread_rng::uniform<f64>();
+    const Vector2D u = sampler.get2D();
+    const f64 x1 = u.x;
+    const f64 x2 = u.y;
 
     const f64 exp = 1.0 / (mPhong + 1.0);
 
@@ -32,3 +35,15 @@ Option<ScatterRecord> Specular::scatter(
 
     return ScatterRecord(scattered, mColor);
 }
+
+void Specular::save(BinaryWriter& writer) const {
+    Material::save(writer);
+    writer.writeXYZ(mColor);
+    writer.write(mPhong);
+}
+
+std::shared_ptr<Specular> Specular::load(BinaryReader& reader) {
+    const Vector3D color = reader.readXYZ<Vector3D>();
+    const f64 phong = reader.read<f64>();
+    return std::make_shared<Specular>(color, phong);
+}
@@ -12,9 +12,17 @@ public:
     /// properties correspond to a specular reflector controlled with a Phong
     /// coefficient.
     Option<ScatterRecord> scatter(
-        const Ray& incident, const SurfaceInteraction& interaction
+        const Ray& incident,
+        const SurfaceInteraction& interaction,
+        Sampler& sampler
     ) const override;
 
+    /// @brief Writes the kind and parameters of the material.
+    void save(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by save() after the kind.
+    static std::shared_ptr<Specular> load(BinaryReader& reader);
+
 private:
     Vector3D mColor;
     f64 mPhong;
@@ -3,11 +3,16 @@
 SurfaceInteraction::SurfaceInteraction(
     const Point3D& p, const Normal3D& n, const Face face, const f64 t
 )
-    : p(p), n(n), face(face), mat(nullptr), t(t) {
+    : p(p), n(n), face(face), mat(nullptr), prim(nullptr), t(t) {
 }
 
 SurfaceInteraction::SurfaceInteraction(const SurfaceInteraction& other)
-    : p(other.p), n(other.n), face(other.face), mat(other.mat), t(other.t) {
+    : p(other.p),
+      n(other.n),
+      face(other.face),
+      mat(other.mat),
+      prim(other.prim),
+      t(other.t) {
 }
 
 SurfaceInteraction SurfaceInteraction::operator=(
@@ -17,6 +22,7 @@ SurfaceInteraction SurfaceInteraction::operator=(
     n = other.n;
     face = other.face;
     mat = other.mat;
+    prim = other.prim;
     t = other.t;
 
     return *this;
@@ -27,6 +33,7 @@ SurfaceInteraction::SurfaceInteraction(SurfaceInteraction&& other)
       n(std::move(other.n)),
       face(std::move(other.face)),
       mat(std::move(other.mat)),
+      prim(other.prim),
       t(std::move(other.t)) {
 }
 
@@ -35,6 +42,7 @@ SurfaceInteraction SurfaceInteraction::operator=(SurfaceInteraction&& other) {
     n = std::move(other.n);
     face = std::move(other.face);
     mat = std::move(other.mat);
+    prim = other.prim;
     t = std::move(other.t);
 
     return *this;
@@ -8,6 +8,8 @@
 class Material;
 using MaterialPtr = std::shared_ptr<Material>;
 
+class Primitive;
+
 /// @brief Ray-surface interaction record.
 struct SurfaceInteraction {
     enum class Face {
@@ -19,6 +21,7 @@ struct SurfaceInteraction {
     Normal3D n;
     Face face;
     MaterialPtr mat;
+    const Primitive* prim;
     f64 t;
 
     SurfaceInteraction(
@@ -1,150 +1,1037 @@
 #include "render/pathtracer.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <stdexcept>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "common/util/framebuffer.hpp"
+#include "common/util/hash.hpp"
 #include "common/util/log.hpp"
 #include "matrix_stack.hpp"
 #include "render/bvh.hpp"
+#include "render/checkpoint.hpp"
+#include "render/linear_bvh.hpp"
 #include "render/material/emissive.hpp"
+#include "render/pixel_stats.hpp"
 #include "render/prim_list.hpp"
+#include "render/primitive/mesh_prim.hpp"
+#include "render/sampler/independent_sampler.hpp"
+#include "render/sampler/pmj02_sampler.hpp"
+#include "render/sampler/sobol_sampler.hpp"
+#include "render/sampler/stratified_sampler.hpp"
+#include "render/scene_cache.hpp"
+#include "render/scene_snapshot.hpp"
+#include "render/wide_bvh.hpp"
+#include "render/worker_pool.hpp"
 #include "scene/nodes/geometry_node.hpp"
 
 namespace {
 
-void collapsePrimitivesRecursive(
+/// @brief Runs `work(thread, item)` for every item in [0, item_count) on
+/// `thread_count` threads. Threads repeatedly claim the next unprocessed item,
+/// so threads that draw cheap items process more of them.
+template <typename Work>
+void dispatch(const Size thread_count, const Size item_count, Work&& work) {
+    std::atomic<Index> next_item(0);
+
+    std::vector<f64> busy_seconds(thread_count, 0.0);
+    std::vector<Size> items_processed(thread_count, 0);
+
+    auto run = [&](const Index thread) {
+        const auto thread_start = std::chrono::steady_clock::now();
+
+        while (true) {
+            const Index item = next_item.fetch_add(1);
+            if (item >= item_count)
+                break;
+
+            work(thread, item);
+
+            ++items_processed[thread];
+        }
+
+        const std::chrono::duration<f64> busy =
+            std::chrono::steady_clock::now() - thread_start;
+        busy_seconds[thread] = busy.count();
+    };
+
+    std::vector<std::thread> threads;
+    for (Index i = 0; i < thread_count; ++i)
+        threads.emplace_back(run, i);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (Index i = 0; i < thread_count; ++i)
+        Log::d(
+            "Thread {}: {} items, busy {} s",
+            i,
+            items_processed[i],
+            busy_seconds[i]
+        );
+
+    const auto [min_busy, max_busy] =
+        std::minmax_element(std::begin(busy_seconds), std::end(busy_seconds));
+    Log::i("Thread busy time: min = {} s, max = {} s", *min_busy, *max_busy);
+}
+
+/// @brief Offset below the light distance within which shadow ray hits are
+/// taken to be the light itself. Matches the minimum ray parameter used by the
+/// spatial structures.
+constexpr f64 cShadowEpsilon = 0.001;
+
+/// @brief Power heuristic multiple importance sampling weight for a sample
+/// from the strategy with density `pdf` against one with density `other`.
+f64 powerHeuristic(const f64 pdf, const f64 other) {
+    const f64 a = pdf * pdf;
+    const f64 b = other * other;
+    return (a + b > 0.0) ? a / (a + b) : 0.0;
+}
+
+/// @brief Geometry node reached while collapsing the scene graph, with its
+/// accumulated object to world transform.
+struct CollapsedGeometry {
+    const GeometryNode* node;
+    Transform objectToWorld;
+};
+
+void collapseGeometryRecursive(
     const SceneNodePtr& node,
     MatrixStack& stack,
-    std::vector<PrimitivePtr>& primitives
+    std::vector<CollapsedGeometry>& geometries
 ) {
     stack.push(node->transform().transform());
 
-    if (const GeometryNode* geo = dynamic_cast<GeometryNode*>(node.get())) {
-        PrimitivePtr primitive = geo->buildPrimitive();
+    if (const GeometryNode* geo = dynamic_cast<GeometryNode*>(node.get()))
+        geometries.push_back(CollapsedGeometry{geo, stack.reduce()});
+
+    for (const SceneNodePtr& child : node->children())
+        collapseGeometryRecursive(child, stack, geometries);
 
-        primitive->setMaterial(geo->material());
-        primitive->setObjectToWorld(stack.reduce());
+    stack.pop();
+}
 
-        primitives.push_back(std::move(primitive));
+/// @brief Assigns the material and transform of each geometry to its
+/// primitive.
+void placePrimitives(
+    const std::vector<CollapsedGeometry>& geometries,
+    const std::vector<PrimitivePtr>& primitives
+) {
+    for (Index i = 0; i < geometries.size(); ++i) {
+        primitives[i]->setMaterial(geometries[i].node->material());
+        primitives[i]->setObjectToWorld(geometries[i].objectToWorld);
     }
+}
 
-    for (const SceneNodePtr& child : node->children())
-        collapsePrimitivesRecursive(child, stack, primitives);
+/// @brief Hashes everything the scene contributes to the image: the kind,
+/// transform and material of every geometry, the vertices and triangles of
+/// every mesh and the bounds of every implicit primitive. Material parameters
+/// are not exposed, so materials are identified by their kind and by which
+/// geometries share them.
+u64 hashScene(
+    const std::vector<CollapsedGeometry>& geometries,
+    const std::vector<PrimitivePtr>& primitives
+) {
+    std::map<const Material*, Index> material_ids;
+    std::map<const TriangleMesh*, Index> first_by_mesh;
 
-    stack.pop();
+    Hasher hasher;
+    hasher.add<u64>(geometries.size());
+
+    for (Index i = 0; i < geometries.size(); ++i) {
+        const GeometryNode* node = geometries[i].node;
+        const Matrix4D& matrix = geometries[i].objectToWorld.matrix();
+        const Material* material = node->material().get();
+
+        hasher.add(node->primitiveKind());
+        hasher.addBytes(matrix.data(), 16 * sizeof(f64));
+        hasher.add(material ? material->kind() : Material::Kind::Null);
+        hasher.add<u64>(
+            material_ids.try_emplace(material, material_ids.size())
+                .first->second
+        );
+
+        if (node->primitiveKind() == Primitive::Kind::Mesh) {
+            const std::shared_ptr<const TriangleMesh> mesh =
+                node->geometry()->sharedMesh();
+            const auto [it, inserted] =
+                first_by_mesh.try_emplace(mesh.get(), i);
+            hasher.add<u64>(it->second);
+            if (!inserted)
+                continue;
+
+            hasher.add<u64>(mesh->vertices().size());
+            for (const Vertex& vertex : mesh->vertices()) {
+                hasher.add(vertex.p.x);
+                hasher.add(vertex.p.y);
+                hasher.add(vertex.p.z);
+                hasher.add(vertex.n.x);
+                hasher.add(vertex.n.y);
+                hasher.add(vertex.n.z);
+                hasher.add(vertex.uv.x);
+                hasher.add(vertex.uv.y);
+            }
+            hasher.addVector(mesh->triangles());
+        } else {
+            for (Index axis = 0; axis < 3; ++axis) {
+                hasher.add(primitives[i]->aabb().axis(axis).min);
+                hasher.add(primitives[i]->aabb().axis(axis).max);
+            }
+        }
+    }
+
+    return hasher.value();
 }
 
+/// @brief Builds the primitives and the spatial structure, reusing the
+/// acceleration data in the scene cache if it was built from the same inputs.
+/// The key covers the build configuration, every transform, the triangles of
+/// every mesh and the bounds of every implicit primitive. Implicit primitives
+/// are cheap to create, so only their bounds matter to the cached data.
+/// Geometries that share a mesh share its acceleration data, which is hashed
+/// and stored once.
+void buildCached(
+    const std::vector<CollapsedGeometry>& geometries,
+    const Config& config,
+    SpatialStructure& world,
+    std::vector<PrimitivePtr>& primitives
+) {
+    std::vector<std::shared_ptr<const TriangleMesh>> meshes(geometries.size());
+    primitives.assign(geometries.size(), nullptr);
+
+    // Index of the first geometry with the same mesh as each mesh geometry.
+    std::vector<Index> first(geometries.size());
+    std::map<const TriangleMesh*, Index> first_by_mesh;
+
+    Hasher hasher;
+    hasher.add(SceneCache::VERSION);
+    hasher.add(config.spatialKind);
+    hasher.add<u64>(config.sahBinCount);
+    hasher.add(config.sahTraversalCost);
+    hasher.add(config.sahIntersectionCost);
+
+    for (Index i = 0; i < geometries.size(); ++i) {
+        const GeometryNode* node = geometries[i].node;
+        const Matrix4D& matrix = geometries[i].objectToWorld.matrix();
+
+        hasher.add(node->primitiveKind());
+        hasher.addBytes(matrix.data(), 16 * sizeof(f64));
+
+        if (node->primitiveKind() == Primitive::Kind::Mesh) {
+            meshes[i] = node->geometry()->sharedMesh();
+            first[i] =
+                first_by_mesh.try_emplace(meshes[i].get(), i).first->second;
+            hasher.add<u64>(first[i]);
+            if (first[i] != i)
+                continue;
+
+            // The cached data depends on the vertex positions only.
+            hasher.add<u64>(meshes[i]->vertices().size());
+            for (const Vertex& vertex : meshes[i]->vertices()) {
+                hasher.add(vertex.p.x);
+                hasher.add(vertex.p.y);
+                hasher.add(vertex.p.z);
+            }
+            hasher.addVector(meshes[i]->triangles());
+        } else {
+            primitives[i] = node->buildPrimitive();
+            for (Index axis = 0; axis < 3; ++axis) {
+                hasher.add(primitives[i]->aabb().axis(axis).min);
+                hasher.add(primitives[i]->aabb().axis(axis).max);
+            }
+        }
+    }
+
+    // Instances copy the primitive of the first geometry with their mesh,
+    // which shares its acceleration data.
+    auto copy_instances = [&]() {
+        for (Index i = 0; i < geometries.size(); ++i)
+            if (meshes[i] && first[i] != i)
+                primitives[i] = std::make_shared<MeshPrim>(
+                    static_cast<const MeshPrim&>(*primitives[first[i]])
+                );
+    };
+
+    const u64 key = hasher.value();
+    const SceneCache cache(config.sceneCacheDir);
+    LinearBVH* linear_bvh = dynamic_cast<LinearBVH*>(&world);
+
+    try {
+        if (Option<SceneCache::Entry> entry = cache.load(key)) {
+            BinaryReader& reader = entry->reader();
+
+            for (Index i = 0; i < geometries.size(); ++i) {
+                if (meshes[i] && first[i] == i)
+                    primitives[i] =
+                        std::make_shared<MeshPrim>(meshes[i], reader);
+            }
+            copy_instances();
+
+            placePrimitives(geometries, primitives);
+
+            if (linear_bvh)
+                linear_bvh->load(primitives, reader);
+            else
+                world.build(primitives);
+
+            Log::i("Loaded scene snapshot {}", key);
+            return;
+        }
+    } catch (const std::runtime_error& e) {
+        Log::w("Rebuilding scene, snapshot {} is unusable: {}", key, e.what());
+    }
+
+    // Meshes are built by their nodes, which may provide prebuilt data.
+    for (Index i = 0; i < geometries.size(); ++i)
+        if (meshes[i] && first[i] == i)
+            primitives[i] = geometries[i].node->buildPrimitive();
+    copy_instances();
+
+    placePrimitives(geometries, primitives);
+    world.build(primitives);
+
+    try {
+        BinaryWriter writer = cache.store(key);
+        for (Index i = 0; i < geometries.size(); ++i)
+            if (meshes[i] && first[i] == i)
+                static_cast<const MeshPrim&>(*primitives[i]).save(writer);
+        if (linear_bvh)
+            linear_bvh->save(writer);
+        writer.commit();
+
+        Log::i("Saved scene snapshot {}", key);
+    } catch (const std::runtime_error& e) {
+        Log::w("Could not save scene snapshot {}: {}", key, e.what());
+    }
 }
 
-Pathtracer::Pathtracer(
-    const SceneGraph& scene, const Camera& camera, const Config& config
-)
-    : config(config), mWorld(nullptr), mCamera(camera) {
-    MatrixStack stack;
-    std::vector<PrimitivePtr> primitives;
-    collapsePrimitivesRecursive(scene.root(), stack, primitives);
+/// @brief Creates the configured spatial structure.
+/// @throws std::invalid_argument if the SAH parameters are out of range.
+std::unique_ptr<SpatialStructure> makeWorld(const Config& config) {
+    // The SAH parameters come from the user, so they are checked here rather
+    // than asserted by the builders.
+    if (config.sahBinCount < 2)
+        throw std::invalid_argument("sah_bin_count must be at least 2");
+    if (!std::isfinite(config.sahTraversalCost) ||
+        config.sahTraversalCost < 0.0)
+        throw std::invalid_argument(
+            "sah_traversal_cost must be finite and not negative"
+        );
+    if (!std::isfinite(config.sahIntersectionCost) ||
+        config.sahIntersectionCost <= 0.0)
+        throw std::invalid_argument(
+            "sah_intersection_cost must be finite and positive"
+        );
+
+    SAHParams params;
+    params.binCount = config.sahBinCount;
+    params.traversalCost = config.sahTraversalCost;
+    params.intersectionCost = config.sahIntersectionCost;
 
     switch (config.spatialKind) {
     case SpatialKind::PrimList:
-        mWorld = std::make_unique<PrimList>();
-        break;
+        return std::make_unique<PrimList>();
     case SpatialKind::BVH:
-        mWorld = std::make_unique<BVH>();
-        break;
+        return std::make_unique<BVH>();
+    case SpatialKind::BVHSAH:
+        return std::make_unique<BVH>(BVH::SplitMethod::SAH, params);
+    case SpatialKind::LinearBVH:
+        return std::make_unique<LinearBVH>(params);
+    case SpatialKind::WideBVH:
+        return std::make_unique<WideBVH>(params);
     default:
         unreachable;
     }
+}
+
+/// @brief Visits the pixels of a tile of a distributed render, row by row,
+/// with the offset of their values in the tile result. The coordinator and
+/// the workers visit them in the same order, so that results need no pixel
+/// coordinates.
+template <typename Visit>
+void forEachTilePixel(
+    const Camera& camera, const Size tile_size, const Index tile, Visit&& visit
+) {
+    const Size tiles_x = (camera.nx() + tile_size - 1) / tile_size;
+    const Index x0 = (tile % tiles_x) * tile_size;
+    const Index y0 = (tile / tiles_x) * tile_size;
+    const Index x1 = std::min(x0 + tile_size, camera.nx());
+    const Index y1 = std::min(y0 + tile_size, camera.ny());
+
+    Index offset = 0;
+    for (Index py = y0; py < y1; ++py)
+        for (Index px = x0; px < x1; ++px, offset += 3)
+            visit(px, py, offset);
+}
+
+/// @brief Reads an enumerator written as its underlying value.
+/// @throws std::runtime_error if the value is past `last`.
+template <typename T>
+T readEnum(BinaryReader& reader, const T last) {
+    const auto value = reader.read<std::underlying_type_t<T>>();
+    if (value < 0 || value > static_cast<decltype(value)>(last))
+        throw std::runtime_error("render job has an invalid option");
+    return static_cast<T>(value);
+}
+
+/// @brief Writes the options that workers of a distributed render use.
+void writeJobConfig(BinaryWriter& writer, const Config& config) {
+    writer.write(config.renderingMode);
+    writer.write(config.samplingKind);
+    writer.write(config.spatialKind);
+    writer.write(config.integratorKind);
+    writer.write<u64>(config.samplesPerPixel);
+    writer.write<u64>(config.traceDepth);
+    writer.write<u64>(config.rouletteDepth);
+    writer.write<u64>(config.seed);
+    writer.write<u64>(config.tileSize);
+    writer.write<u64>(config.sahBinCount);
+    writer.write(config.sahTraversalCost);
+    writer.write(config.sahIntersectionCost);
+}
+
+/// @brief Reads the options written by writeJobConfig(). The others keep
+/// their defaults.
+Config readJobConfig(BinaryReader& reader) {
+    Config config;
+    config.renderingMode = readEnum(reader, RenderingMode::NormalMap);
+    config.samplingKind = readEnum(reader, SamplingKind::PMJ02);
+    config.spatialKind = readEnum(reader, SpatialKind::WideBVH);
+    config.integratorKind = readEnum(reader, IntegratorKind::NextEvent);
+    config.samplesPerPixel = reader.read<u64>();
+    config.traceDepth = reader.read<u64>();
+    config.rouletteDepth = reader.read<u64>();
+    config.seed = reader.read<u64>();
+    config.tileSize = reader.read<u64>();
+    config.sahBinCount = reader.read<u64>();
+    config.sahTraversalCost = reader.read<f64>();
+    config.sahIntersectionCost = reader.read<f64>();
+    return config;
+}
+
+}
+
+Pathtracer::Pathtracer(
+    const SceneGraph& scene, const Camera& camera, const Config& config
+)
+    : config(config),
+      mWorld(makeWorld(config)),
+      mPrimitives(),
+      mLights(),
+      mCamera(camera),
+      mSceneHash(0) {
+    const auto start = std::chrono::steady_clock::now();
+
+    MatrixStack stack;
+    std::vector<CollapsedGeometry> geometries;
+    collapseGeometryRecursive(scene.root(), stack, geometries);
+
+    if (config.sceneCacheDir.empty()) {
+        for (const CollapsedGeometry& geometry : geometries)
+            mPrimitives.push_back(geometry.node->buildPrimitive());
+
+        placePrimitives(geometries, mPrimitives);
+        mWorld->build(mPrimitives);
+    } else {
+        buildCached(geometries, config, *mWorld, mPrimitives);
+    }
+
+    const std::chrono::duration<f64> elapsed =
+        std::chrono::steady_clock::now() - start;
+    Log::i("Scene build time = {} s", elapsed.count());
+
+    if (!config.checkpointPath.empty() || !config.resumeFrom.empty())
+        mSceneHash = hashScene(geometries, mPrimitives);
+
+    buildLights();
+
+    if (const BVH* bvh = dynamic_cast<BVH*>(mWorld.get()))
+        Log::i("BVH SAH cost = {}", bvh->sahCost());
+    else if (const LinearBVH* bvh = dynamic_cast<LinearBVH*>(mWorld.get()))
+        Log::i("BVH SAH cost = {}", bvh->sahCost());
+    else if (const WideBVH* bvh = dynamic_cast<WideBVH*>(mWorld.get()))
+        Log::i("BVH SAH cost = {}", bvh->sahCost());
+}
+
+Pathtracer::Pathtracer(
+    BinaryReader& snapshot, const Camera& camera, const Config& config
+)
+    : config(config),
+      mWorld(makeWorld(config)),
+      mPrimitives(),
+      mLights(),
+      mCamera(camera),
+      mSceneHash(0) {
+    const auto start = std::chrono::steady_clock::now();
+
+    mPrimitives = scene_snapshot::read(snapshot, *mWorld);
+
+    const std::chrono::duration<f64> elapsed =
+        std::chrono::steady_clock::now() - start;
+    Log::i("Scene load time = {} s", elapsed.count());
+
+    buildLights();
+}
+
+WorkerPool::Work Pathtracer::startWorker(std::span<const u8> job) {
+    BinaryReader reader(job);
+
+    const Config config = readJobConfig(reader);
+    const auto camera = std::make_shared<const Camera>(reader);
+    if (camera->nx() == 0 || camera->ny() == 0)
+        throw std::runtime_error("render job has an empty image");
+
+    const std::shared_ptr<const Pathtracer> pathtracer(
+        new Pathtracer(reader, *camera, config)
+    );
+    if (reader.remaining() > 0)
+        throw std::runtime_error("render job has trailing data");
+
+    // Every worker renders its tiles on a single thread with its own sampler,
+    // so the worker count sets the parallelism.
+    const std::shared_ptr<Sampler> sampler = pathtracer->makeSampler();
+
+    return [camera, pathtracer, sampler](
+               const Index tile, std::vector<f64>& result
+           ) { pathtracer->renderTile(tile, *sampler, result); };
+}
 
-    mWorld->build(primitives);
+void Pathtracer::buildLights() {
+    if (config.integratorKind == IntegratorKind::NextEvent) {
+        mLights.build(mPrimitives);
+        Log::i("Light count = {}", mLights.size());
+    }
 }
 
 Image Pathtracer::render() const {
     Image image(mCamera.nx(), mCamera.ny());
 
-    const Size thread_count = 8;
-    Log::i("Hardware concurrency = {}", thread_count);
+    const auto start = std::chrono::steady_clock::now();
 
-    std::vector<std::thread> threads;
+    Size sample_count = 0;
 
-    const f64 color_scale = 1.0 / static_cast<f64>(config.samplesPerPixel);
+    if (config.workers > 0 || !config.workerAddresses.empty()) {
+        sample_count = renderDistributed(image);
+    } else {
+        const Size hardware_threads =
+            std::max<Size>(std::thread::hardware_concurrency(), 1);
+        const Size thread_count =
+            (config.threads > 0) ? config.threads : hardware_threads;
+        Log::i(
+            "Threads = {} (hardware concurrency = {})",
+            thread_count,
+            hardware_threads
+        );
 
-    auto render_rows = [&](Index row_start, Index row_end) {
-        for (Index py = row_start; py < row_end; ++py) {
-            for (Index px = 0; px < mCamera.nx(); ++px) {
-                Vector3D color = Vector3D::zero();
+        std::vector<SamplerPtr> samplers;
+        for (Index i = 0; i < thread_count; ++i)
+            samplers.push_back(makeSampler());
 
-                if (config.samplingKind == SamplingKind::Center) {
-                    const Ray ray = generate(px, py);
-                    color = shadeRecursive(ray, 1);
-                } else {
-                    for (Index sample = 0; sample < config.samplesPerPixel;
-                         ++sample) {
-                        const Ray ray = generate(px, py);
+        sample_count = (config.adaptiveThreshold > 0.0)
+                           ? renderAdaptive(image, samplers)
+                           : renderUniform(image, samplers);
+    }
 
-                        color += shadeRecursive(ray, 1);
-                    }
+    const std::chrono::duration<f64> elapsed =
+        std::chrono::steady_clock::now() - start;
+    Log::i("Render time = {} s", elapsed.count());
+    Log::i(
+        "Samples per second = {}",
+        static_cast<f64>(sample_count) / elapsed.count()
+    );
 
-                    color *= color_scale;
-                }
+    return image;
+}
+
+Size Pathtracer::renderUniform(
+    Image& image, std::vector<SamplerPtr>& samplers
+) const {
+    const auto start = std::chrono::steady_clock::now();
+
+    // Split the image into square tiles. Threads repeatedly claim the next
+    // unrendered tile, so threads covering cheap regions pick up more tiles.
+    const Size tile_size = std::max<Size>(config.tileSize, 1);
+    const Size tiles_x = (mCamera.nx() + tile_size - 1) / tile_size;
+    const Size tiles_y = (mCamera.ny() + tile_size - 1) / tile_size;
+    const Size tile_count = tiles_x * tiles_y;
+    Log::i("Tile size = {} ({} tiles)", tile_size, tile_count);
+    if (config.packetTracing)
+        Log::i("Packet size = {}x{}", PACKET_SIZE, PACKET_SIZE);
+
+    const Size spp = (config.samplingKind == SamplingKind::Center)
+                         ? 1
+                         : config.samplesPerPixel;
+
+    // Without a pass size, a time budget or periodic checkpoints refine the
+    // image one sample per pixel at a time, as both are only checked between
+    // passes.
+    Size pass_spp = spp;
+    if (config.passSpp > 0)
+        pass_spp = std::min(config.passSpp, spp);
+    else if (config.timeBudgetSeconds > 0.0 || !config.checkpointPath.empty())
+        pass_spp = 1;
+
+    const u64 config_hash =
+        Checkpoint::hashConfig(config, mCamera, mSceneHash);
+
+    Checkpoint checkpoint{
+        config_hash, 0, Framebuffer(mCamera.nx(), mCamera.ny())
+    };
+
+    if (!config.resumeFrom.empty()) {
+        checkpoint = Checkpoint::load(config.resumeFrom.c_str());
+        if (checkpoint.configHash != config_hash)
+            throw std::runtime_error(
+                "checkpoint was written with a different configuration: " +
+                config.resumeFrom
+            );
+        Log::i(
+            "Resumed from {} at {} spp",
+            config.resumeFrom.c_str(),
+            checkpoint.nextSample
+        );
+    }
+
+    Framebuffer& framebuffer = checkpoint.framebuffer;
+
+    const Size resumed_spp = checkpoint.nextSample;
+    Size rendered_spp = resumed_spp;
+    auto last_snapshot = start;
+    auto last_checkpoint = start;
+
+    auto save_checkpoint = [&]() {
+        checkpoint.nextSample = rendered_spp;
+        checkpoint.save(config.checkpointPath.c_str());
+        Log::d("Saved checkpoint at {} spp", rendered_spp);
+    };
+
+    for (Index pass = 0; rendered_spp < spp; ++pass) {
+        const auto pass_start = std::chrono::steady_clock::now();
+        const Size first = rendered_spp;
+        const Size count = std::min(pass_spp, spp - rendered_spp);
+
+        auto render_tile = [&](const Index thread, const Index tile) {
+            Sampler& sampler = *samplers[thread];
+
+            const Index x0 = (tile % tiles_x) * tile_size;
+            const Index y0 = (tile / tiles_x) * tile_size;
+            const Index x1 = std::min(x0 + tile_size, mCamera.nx());
+            const Index y1 = std::min(y0 + tile_size, mCamera.ny());
+
+            if (config.packetTracing) {
+                renderPackets(
+                    x0, y0, x1, y1, first, count, sampler, framebuffer
+                );
+                return;
+            }
 
-                image.set(px, py, color);
+            for (Index py = y0; py < y1; ++py) {
+                for (Index px = x0; px < x1; ++px) {
+                    const Vector3D sum =
+                        renderPixel(px, py, first, count, sampler);
+                    framebuffer.add(px, py, sum, count);
+                }
             }
+        };
+
+        dispatch(samplers.size(), tile_count, render_tile);
+
+        rendered_spp += count;
+
+        const auto now = std::chrono::steady_clock::now();
+        const std::chrono::duration<f64> pass_seconds = now - pass_start;
+        const std::chrono::duration<f64> elapsed = now - start;
+
+        if (pass_spp < spp)
+            Log::i(
+                "Pass {}: {} spp in {} s ({} spp total)",
+                pass,
+                count,
+                pass_seconds.count(),
+                rendered_spp
+            );
+
+        const std::chrono::duration<f64> since_snapshot = now - last_snapshot;
+        if (!config.snapshotPath.empty() && rendered_spp < spp &&
+            since_snapshot.count() >= config.snapshotIntervalSeconds) {
+            Image snapshot(mCamera.nx(), mCamera.ny());
+            framebuffer.resolve(snapshot);
+            snapshot.save(config.snapshotPath.c_str());
+            last_snapshot = now;
+            Log::d("Saved snapshot at {} spp", rendered_spp);
         }
+
+        const std::chrono::duration<f64> since_checkpoint =
+            now - last_checkpoint;
+        if (!config.checkpointPath.empty() && rendered_spp < spp &&
+            since_checkpoint.count() >= config.checkpointIntervalSeconds) {
+            save_checkpoint();
+            last_checkpoint = now;
+        }
+
+        // Stop before a pass that would likely overrun the budget, so that
+        // the render lands close to the requested wall-clock time.
+        if (config.timeBudgetSeconds > 0.0 && rendered_spp < spp &&
+            elapsed.count() + pass_seconds.count() > config.timeBudgetSeconds) {
+            Log::i(
+                "Time budget of {} s reached after {} spp",
+                config.timeBudgetSeconds,
+                rendered_spp
+            );
+            break;
+        }
+    }
+
+    // Always leave a final checkpoint, so that a render cut short by the
+    // time budget can be continued.
+    if (!config.checkpointPath.empty())
+        save_checkpoint();
+
+    framebuffer.resolve(image);
+
+    return mCamera.nx() * mCamera.ny() * (rendered_spp - resumed_spp);
+}
+
+Size Pathtracer::renderDistributed(Image& image) const {
+    if (config.adaptiveThreshold > 0.0 || config.passSpp > 0 ||
+        config.timeBudgetSeconds > 0.0 || !config.checkpointPath.empty() ||
+        !config.resumeFrom.empty())
+        throw std::runtime_error(
+            "adaptive sampling, progressive passes and checkpoints are not "
+            "supported with workers"
+        );
+
+    const Size tile_size = std::max<Size>(config.tileSize, 1);
+    const Size tiles_x = (mCamera.nx() + tile_size - 1) / tile_size;
+    const Size tiles_y = (mCamera.ny() + tile_size - 1) / tile_size;
+    const Size tile_count = tiles_x * tiles_y;
+    Log::i(
+        "Workers = {} forked, {} remote, tile size = {} ({} tiles)",
+        config.workers,
+        config.workerAddresses.size(),
+        tile_size,
+        tile_count
+    );
+
+    const Size spp = (config.samplingKind == SamplingKind::Center)
+                         ? 1
+                         : config.samplesPerPixel;
+
+    // Workers render from the job alone, so forked and remote workers
+    // recreate the same scene.
+    BinaryWriter job;
+    writeJobConfig(job, config);
+    mCamera.save(job);
+    scene_snapshot::write(job, mPrimitives, *mWorld);
+    Log::i("Job size = {} bytes", job.bytes().size());
+
+    auto tile_values = [&](const Index tile) {
+        Size value_count = 0;
+        forEachTilePixel(mCamera, tile_size, tile, [&](Index, Index, Index) {
+            value_count += 3;
+        });
+        return value_count;
     };
 
-    const Size rows_per_thread = mCamera.ny() / thread_count;
+    Framebuffer framebuffer(mCamera.nx(), mCamera.ny());
+
+    // Each pixel receives exactly one result, so the merged image does not
+    // depend on which worker rendered a tile or on the arrival order.
+    auto merge_tile = [&](const Index tile, const std::vector<f64>& result) {
+        forEachTilePixel(
+            mCamera,
+            tile_size,
+            tile,
+            [&](const Index px, const Index py, const Index i) {
+                const Vector3D sum(result[i], result[i + 1], result[i + 2]);
+                framebuffer.add(px, py, sum, spp);
+            }
+        );
+    };
+
+    WorkerPool pool(
+        config.workers, config.workerAddresses, job.bytes(), &startWorker
+    );
+    pool.run(tile_count, tile_values, merge_tile);
+
+    framebuffer.resolve(image);
+
+    return mCamera.nx() * mCamera.ny() * spp;
+}
+
+void Pathtracer::renderTile(
+    const Index tile, Sampler& sampler, std::vector<f64>& result
+) const {
+    const Size tile_size = std::max<Size>(config.tileSize, 1);
+    const Size spp = (config.samplingKind == SamplingKind::Center)
+                         ? 1
+                         : config.samplesPerPixel;
+
+    forEachTilePixel(
+        mCamera,
+        tile_size,
+        tile,
+        [&](const Index px, const Index py, Index) {
+            const Vector3D sum = renderPixel(px, py, 0, spp, sampler);
+            result.push_back(sum.x);
+            result.push_back(sum.y);
+            result.push_back(sum.z);
+        }
+    );
+}
+
+Size Pathtracer::renderAdaptive(
+    Image& image, std::vector<SamplerPtr>& samplers
+) const {
+    const Size min_spp = std::max<Size>(config.minSpp, 2);
+    const Size max_spp = std::max<Size>(config.maxSpp, min_spp);
+    Log::i(
+        "Adaptive sampling: threshold = {}, spp = [{}, {}]",
+        config.adaptiveThreshold,
+        min_spp,
+        max_spp
+    );
+
+    if (!config.checkpointPath.empty() || !config.resumeFrom.empty())
+        Log::w("Checkpoints are not supported with adaptive sampling");
+
+    const Size nx = mCamera.nx();
+    const Size ny = mCamera.ny();
+
+    // Order the pixels tile by tile so that consecutive work items stay
+    // spatially coherent.
+    const Size tile_size = std::max<Size>(config.tileSize, 1);
+    std::vector<Index> active;
+    active.reserve(nx * ny);
+    for (Index ty = 0; ty < ny; ty += tile_size)
+        for (Index tx = 0; tx < nx; tx += tile_size)
+            for (Index py = ty; py < std::min(ty + tile_size, ny); ++py)
+                for (Index px = tx; px < std::min(tx + tile_size, nx); ++px)
+                    active.push_back(py * nx + px);
+
+    std::vector<PixelStats> stats(nx * ny);
+
+    const Size chunk_size = tile_size * tile_size;
+
+    // Every pixel starts with min_spp samples. Each later round doubles the
+    // sample count of the pixels whose error is still above the threshold.
+    Size rendered_spp = 0;
+    Size round_spp = min_spp;
+    Size total_samples = 0;
+
+    for (Index round = 0; !active.empty(); ++round) {
+        Log::i(
+            "Adaptive round {}: {} active pixels, {} spp each",
+            round,
+            active.size(),
+            round_spp
+        );
+
+        const Size chunk_count = (active.size() + chunk_size - 1) / chunk_size;
+
+        auto render_chunk = [&](const Index thread, const Index chunk) {
+            Sampler& sampler = *samplers[thread];
 
-    for (Index i = 0; i < thread_count; ++i) {
-        const Index row_start = i * rows_per_thread;
-        const Index row_end = (i == thread_count - 1)
-                                  ? mCamera.ny()
-                                  : row_start + rows_per_thread;
+            const Index begin = chunk * chunk_size;
+            const Index end = std::min(begin + chunk_size, active.size());
 
-        threads.emplace_back(render_rows, row_start, row_end);
+            for (Index i = begin; i < end; ++i) {
+                const Index pixel = active[i];
+                PixelStats& pixel_stats = stats[pixel];
+
+                for (Index sample = rendered_spp;
+                     sample < rendered_spp + round_spp;
+                     ++sample)
+                    pixel_stats.add(
+                        samplePixel(pixel % nx, pixel / nx, sample, sampler)
+                    );
+            }
+        };
+
+        dispatch(samplers.size(), chunk_count, render_chunk);
+
+        total_samples += active.size() * round_spp;
+
+        // Keep the pixels that are neither converged nor out of samples.
+        std::erase_if(active, [&](const Index pixel) {
+            const PixelStats& pixel_stats = stats[pixel];
+            return pixel_stats.count >= max_spp ||
+                   pixel_stats.relativeError() < config.adaptiveThreshold;
+        });
+
+        // Pixels that are still active have all taken every round, so doubling
+        // their total means repeating the number of samples taken so far.
+        rendered_spp += round_spp;
+        round_spp = std::min(rendered_spp, max_spp - rendered_spp);
     }
 
-    for (std::thread& thread : threads) {
-        thread.join();
+    for (Index pixel = 0; pixel < nx * ny; ++pixel)
+        image.set(pixel % nx, pixel / nx, stats[pixel].mean);
+
+    Log::i(
+        "Average spp = {}",
+        static_cast<f64>(total_samples) / static_cast<f64>(nx * ny)
+    );
+
+    if (!config.sppHeatmapPath.empty()) {
+        Image heatmap(nx, ny);
+        for (Index pixel = 0; pixel < nx * ny; ++pixel) {
+            const f64 t = static_cast<f64>(stats[pixel].count) /
+                          static_cast<f64>(max_spp);
+            heatmap.set(pixel % nx, pixel / nx, Vector3D::uniform(t));
+        }
+        heatmap.save(config.sppHeatmapPath.c_str());
+        Log::i("Saved spp heatmap to {}", config.sppHeatmapPath.c_str());
     }
 
-    return image;
+    return total_samples;
 }
 
-Ray Pathtracer::generate(const Index px, const Index py) const {
-    const Point3D origin = mCamera.origin();
+Vector3D Pathtracer::renderPixel(
+    const Index px,
+    const Index py,
+    const Index first,
+    const Size count,
+    Sampler& sampler
+) const {
+    Vector3D color = Vector3D::zero();
 
-    Point3D point_sample;
+    for (Index sample = first; sample < first + count; ++sample)
+        color += samplePixel(px, py, sample, sampler);
 
-    switch (config.samplingKind) {
-    case SamplingKind::Center:
-        point_sample = mCamera.p(px, py);
-        break;
-    case SamplingKind::UniformRandom:
-        point_sample = mCamera.sample(px, py);
-        break;
-    default:
-        unreachable;
+    return color;
+}
+
+void Pathtracer::renderPackets(
+    const Index x0,
+    const Index y0,
+    const Index x1,
+    const Index y1,
+    const Index first,
+    const Size count,
+    Sampler& sampler,
+    Framebuffer& framebuffer
+) const {
+    std::vector<Ray> rays;
+    std::vector<Option<SurfaceInteraction>> hits;
+    std::vector<Vector3D> sums;
+
+    for (Index by = y0; by < y1; by += PACKET_SIZE) {
+        for (Index bx = x0; bx < x1; bx += PACKET_SIZE) {
+            const Index bx1 = std::min(bx + PACKET_SIZE, x1);
+            const Index by1 = std::min(by + PACKET_SIZE, y1);
+
+            sums.assign((bx1 - bx) * (by1 - by), Vector3D::zero());
+
+            for (Index sample = first; sample < first + count; ++sample) {
+                rays.clear();
+                for (Index py = by; py < by1; ++py) {
+                    for (Index px = bx; px < bx1; ++px) {
+                        const Index pixel = py * mCamera.nx() + px;
+                        sampler.startPixelSample(pixel, sample);
+                        rays.push_back(generate(px, py, sampler));
+                    }
+                }
+
+                hits.assign(rays.size(), std::nullopt);
+                mWorld->intersectPacket(rays, hits);
+
+                // Restart each pixel sample and skip the dimensions consumed
+                // by generate(), so that shading draws the same values as in
+                // samplePixel().
+                Index i = 0;
+                for (Index py = by; py < by1; ++py) {
+                    for (Index px = bx; px < bx1; ++px, ++i) {
+                        const Index pixel = py * mCamera.nx() + px;
+                        sampler.startPixelSample(pixel, sample);
+                        if (config.samplingKind != SamplingKind::Center)
+                            sampler.get2D();
+                        sums[i] += shade(rays[i], std::move(hits[i]), sampler);
+                    }
+                }
+            }
+
+            Index i = 0;
+            for (Index py = by; py < by1; ++py)
+                for (Index px = bx; px < bx1; ++px, ++i)
+                    framebuffer.add(px, py, sums[i], count);
+        }
     }
+}
+
+Vector3D Pathtracer::samplePixel(
+    const Index px, const Index py, const Index sample, Sampler& sampler
+) const {
+    sampler.startPixelSample(py * mCamera.nx() + px, sample);
+
+    const Ray ray = generate(px, py, sampler);
+
+    return shade(ray, mWorld->intersect(ray), sampler);
+}
+
+Ray Pathtracer::generate(
+    const Index px, const Index py, Sampler& sampler
+) const {
+    const Point3D origin = mCamera.origin();
+
+    const Point3D point_sample =
+        (config.samplingKind == SamplingKind::Center)
+            ? mCamera.p(px, py)
+            : mCamera.sample(px, py, sampler.get2D());
 
     const Vector3D direction = (point_sample - origin).normalize();
 
     return Ray(origin, direction);
 }
 
-Vector3D Pathtracer::shadeRecursive(const Ray& ray, const Size depth) const {
+Vector3D Pathtracer::shade(
+    const Ray& ray, Option<SurfaceInteraction> hit, Sampler& sampler
+) const {
+    switch (config.integratorKind) {
+    case IntegratorKind::Recursive:
+        return shadeRecursive(ray, hit, 1, sampler);
+    case IntegratorKind::Iterative:
+        return shadeIterative(ray, std::move(hit), sampler);
+    case IntegratorKind::NextEvent:
+        return shadeNextEvent(ray, std::move(hit), sampler);
+    default:
+        unreachable;
+    }
+}
+
+Vector3D Pathtracer::shadeRecursive(
+    const Ray& ray,
+    const Option<SurfaceInteraction>& hit,
+    const Size depth,
+    Sampler& sampler
+) const {
     if (depth >= config.traceDepth)
         return Vector3D::zero();
 
-    if (const Option<SurfaceInteraction> option = mWorld->intersect(ray)) {
-        const MaterialPtr mat = option->mat;
+    if (hit) {
+        const MaterialPtr mat = hit->mat;
 
-        const Option<ScatterRecord> record = mat->scatter(ray, *option);
+        const Option<ScatterRecord> record = mat->scatter(ray, *hit, sampler);
 
         switch (config.renderingMode) {
         case RenderingMode::Full:
             if (record) {
+                // Rays past the trace depth are not traced.
+                const Ray& scattered = record->scattered;
+                const Option<SurfaceInteraction> next =
+                    (depth + 1 < config.traceDepth)
+                        ? mWorld->intersect(scattered)
+                        : std::nullopt;
                 return record->color *
-                       shadeRecursive(record->scattered, depth + 1);
+                       shadeRecursive(scattered, next, depth + 1, sampler);
             } else {
                 if (mat->kind() == Material::Kind::Emissive)
                     return static_cast<Emissive*>(mat.get())->emitted();
@@ -153,7 +1040,7 @@ Vector3D Pathtracer::shadeRecursive(const Ray& ray, const Size depth) const {
             }
             break;
         case RenderingMode::NormalMap:
-            return 0.5 * (option->n.normalize() + Vector3D::one());
+            return 0.5 * (hit->n.normalize() + Vector3D::one());
             break;
         default:
             unreachable;
@@ -163,6 +1050,217 @@ Vector3D Pathtracer::shadeRecursive(const Ray& ray, const Size depth) const {
     return background(ray);
 }
 
+Vector3D Pathtracer::shadeIterative(
+    const Ray& camera_ray,
+    Option<SurfaceInteraction> camera_hit,
+    Sampler& sampler
+) const {
+    Vector3D radiance = Vector3D::zero();
+    Vector3D throughput = Vector3D::one();
+
+    Ray ray = camera_ray;
+
+    for (Size depth = 1; depth < config.traceDepth; ++depth) {
+        const Option<SurfaceInteraction> option =
+            (depth == 1) ? std::move(camera_hit) : mWorld->intersect(ray);
+
+        if (!option) {
+            radiance += throughput * background(ray);
+            break;
+        }
+
+        if (config.renderingMode == RenderingMode::NormalMap)
+            return 0.5 * (option->n.normalize() + Vector3D::one());
+
+        const Material* mat = option->mat.get();
+
+        const Option<ScatterRecord> record =
+            mat->scatter(ray, *option, sampler);
+
+        if (!record) {
+            if (mat->kind() == Material::Kind::Emissive)
+                radiance +=
+                    throughput * static_cast<const Emissive*>(mat)->emitted();
+            break;
+        }
+
+        throughput *= record->color;
+
+        // Russian roulette. Continue with a probability proportional to the
+        // throughput and reweight surviving paths so the estimate stays
+        // unbiased.
+        if (depth >= config.rouletteDepth) {
+            const f64 p = std::min(
+                std::max({throughput.x, throughput.y, throughput.z}), 1.0
+            );
+
+            if (p <= 0.0 || sampler.get1D() >= p)
+                break;
+
+            throughput /= p;
+        }
+
+        ray = record->scattered;
+    }
+
+    return radiance;
+}
+
+Vector3D Pathtracer::shadeNextEvent(
+    const Ray& camera_ray,
+    Option<SurfaceInteraction> camera_hit,
+    Sampler& sampler
+) const {
+    Vector3D radiance = Vector3D::zero();
+    Vector3D throughput = Vector3D::one();
+
+    Ray ray = camera_ray;
+
+    // Solid angle density of the BSDF sample that produced the current ray.
+    // Camera rays and rays scattered by materials other than Lambertian cannot
+    // be generated by light sampling, so emitters they hit count fully.
+    f64 bsdf_pdf = 0.0;
+    bool light_sampled = false;
+
+    for (Size depth = 1; depth < config.traceDepth; ++depth) {
+        const Option<SurfaceInteraction> option =
+            (depth == 1) ? std::move(camera_hit) : mWorld->intersect(ray);
+
+        if (!option) {
+            radiance += throughput * background(ray);
+            break;
+        }
+
+        if (config.renderingMode == RenderingMode::NormalMap)
+            return 0.5 * (option->n.normalize() + Vector3D::one());
+
+        const Material* mat = option->mat.get();
+
+        if (mat->kind() == Material::Kind::Emissive) {
+            const Vector3D emitted =
+                static_cast<const Emissive*>(mat)->emitted();
+
+            f64 weight = 1.0;
+            if (light_sampled) {
+                // Convert the light density at the hit from area to solid
+                // angle measure.
+                const f64 distance = option->t * ray.direction.length();
+                const f64 cos_light = math::abs(
+                    option->n.normalize().dot(ray.direction.normalize())
+                );
+                const f64 light_pdf =
+                    (cos_light > 0.0)
+                        ? mLights.pdf(option->prim, option->n.normalize()) *
+                              math::sqr(distance) / cos_light
+                        : 0.0;
+                weight = powerHeuristic(bsdf_pdf, light_pdf);
+            }
+
+            radiance += throughput * emitted * weight;
+            break;
+        }
+
+        Option<ScatterRecord> record = std::nullopt;
+
+        if (mat->kind() == Material::Kind::Lambertian) {
+            const Lambertian& lambertian = *static_cast<const Lambertian*>(mat);
+
+            radiance += throughput * sampleDirect(*option, lambertian, sampler);
+
+            record = lambertian.scatterCosine(*option, sampler);
+            bsdf_pdf = lambertian.pdf(*option, record->scattered.direction);
+            light_sampled = !mLights.empty();
+        } else {
+            record = mat->scatter(ray, *option, sampler);
+            light_sampled = false;
+        }
+
+        if (!record)
+            break;
+
+        throughput *= record->color;
+
+        // Russian roulette. Continue with a probability proportional to the
+        // throughput and reweight surviving paths so the estimate stays
+        // unbiased.
+        if (depth >= config.rouletteDepth) {
+            const f64 p = std::min(
+                std::max({throughput.x, throughput.y, throughput.z}), 1.0
+            );
+
+            if (p <= 0.0 || sampler.get1D() >= p)
+                break;
+
+            throughput /= p;
+        }
+
+        ray = record->scattered;
+    }
+
+    return radiance;
+}
+
+Vector3D Pathtracer::sampleDirect(
+    const SurfaceInteraction& interaction,
+    const Lambertian& lambertian,
+    Sampler& sampler
+) const {
+    const f64 u_light = sampler.get1D();
+    const Vector2D u_point = sampler.get2D();
+
+    const Option<LightSample> sample =
+        mLights.sample(u_light, u_point.x, u_point.y);
+    if (!sample || sample->pdf <= 0.0)
+        return Vector3D::zero();
+
+    const Vector3D offset = sample->p - interaction.p;
+    const f64 distance = offset.length();
+    if (distance <= cShadowEpsilon)
+        return Vector3D::zero();
+
+    const Vector3D direction = offset / distance;
+
+    const f64 cos_surface = interaction.n.normalize().dot(direction);
+    const f64 cos_light = math::abs(sample->n.dot(direction));
+    if (cos_surface <= 0.0 || cos_light <= 0.0)
+        return Vector3D::zero();
+
+    // Trace the shadow ray. Any hit before the light means it is occluded.
+    const Ray shadow(interaction.p, direction);
+    if (mWorld->occluded(shadow, distance - cShadowEpsilon))
+        return Vector3D::zero();
+
+    const f64 light_pdf = sample->pdf * math::sqr(distance) / cos_light;
+    const f64 bsdf_pdf = lambertian.pdf(interaction, direction);
+    const f64 weight = powerHeuristic(light_pdf, bsdf_pdf);
+
+    const Vector3D brdf = lambertian.albedo() * math::inv_pi<f64>();
+
+    return brdf * sample->radiance * (cos_surface * weight / light_pdf);
+}
+
+SamplerPtr Pathtracer::makeSampler() const {
+    // Adaptive sampling may take up to maxSpp samples in a pixel, so the
+    // sample patterns must be laid out for that many.
+    const Size spp = (config.adaptiveThreshold > 0.0)
+                         ? std::max(config.maxSpp, config.minSpp)
+                         : config.samplesPerPixel;
+
+    switch (config.samplingKind) {
+    case SamplingKind::Center:
+    case SamplingKind::UniformRandom:
+        return std::make_unique<IndependentSampler>(spp, config.seed);
+    case SamplingKind::Stratified:
+        return std::make_unique<StratifiedSampler>(spp, config.seed);
+    case SamplingKind::Sobol:
+        return std::make_unique<SobolSampler>(spp, config.seed);
+    case SamplingKind::PMJ02:
+        return std::make_unique<PMJ02Sampler>(spp, config.seed);
+    default:
+        unreachable;
+    }
+}
+
 Vector3D Pathtracer::background(const Ray& ray) const {
     const Vector3D direction = ray.direction.normalize();
     const f64 a = 0.5 * (direction.y + 1.0);
@@ -1,20 +1,32 @@
 #pragma once
 
+#include <span>
+#include <vector>
+
 #include "common/math/interval.hpp"
 #include "common/math/ray.hpp"
 #include "common/prelude.hpp"
+#include "common/util/binary_io.hpp"
+#include "common/util/framebuffer.hpp"
 #include "common/util/image.hpp"
 #include "render/camera.hpp"
 #include "render/config.hpp"
+#include "render/light_list.hpp"
+#include "render/material/lambertian.hpp"
 #include "render/material/surface_interaction.hpp"
 #include "render/primitive/primitive.hpp"
+#include "render/sampler/sampler.hpp"
 #include "render/spatial_structure.hpp"
+#include "render/worker_pool.hpp"
 #include "scene/scene_graph.hpp"
 
 /// @brief Main path tracer routine class. Performs ray generation, intersection
 /// testing, and pixel shading.
 class Pathtracer {
 public:
+    /// @brief Builds the acceleration structure of the scene.
+    /// @throws std::invalid_argument if the SAH parameters of the
+    /// configuration are out of range.
     Pathtracer(
         const SceneGraph& scene, const Camera& camera, const Config& config
     );
@@ -23,19 +35,154 @@ public:
     /// @brief Renders the scene from the view of the camera.
     Image render() const;
 
+    /// @brief Prepares a worker process for a job of a distributed render.
+    /// Recreates the configuration, camera and scene sent by the coordinator.
+    /// @returns The function that renders a tile of the job.
+    /// @throws std::runtime_error if the job is malformed.
+    static WorkerPool::Work startWorker(std::span<const u8> job);
+
     Config config;
 
 private:
+    /// @brief Recreates the scene of a snapshot written by
+    /// scene_snapshot::write().
+    /// @throws std::runtime_error if the snapshot is malformed.
+    /// @throws std::invalid_argument if the SAH parameters of the
+    /// configuration are out of range.
+    Pathtracer(
+        BinaryReader& snapshot, const Camera& camera, const Config& config
+    );
+
+    /// @brief Width and height in pixels of the blocks traced as packets.
+    static constexpr Size PACKET_SIZE = 8;
+
+    /// @brief Renders every pixel with Config::samplesPerPixel samples,
+    /// accumulated in passes of Config::passSpp samples. Stops early when the
+    /// next pass would exceed Config::timeBudgetSeconds. Continues from
+    /// Config::resumeFrom and writes checkpoints to Config::checkpointPath if
+    /// they are set.
+    /// @returns The number of samples taken.
+    /// @throws std::runtime_error if the checkpoint to resume from is invalid
+    /// or was written with a different configuration.
+    Size renderUniform(Image& image, std::vector<SamplerPtr>& samplers) const;
+
+    /// @brief Renders the image in rounds. Every pixel first takes
+    /// Config::minSpp samples, and each later round doubles the samples of
+    /// the pixels whose relative error is still above
+    /// Config::adaptiveThreshold, up to Config::maxSpp.
+    /// @returns The number of samples taken.
+    Size renderAdaptive(Image& image, std::vector<SamplerPtr>& samplers) const;
+
+    /// @brief Renders the image tile by tile in Config::workers forked worker
+    /// processes and the workers at Config::workerAddresses, and merges their
+    /// results. Every worker receives a snapshot of the scene along with the
+    /// camera and configuration.
+    /// @returns The number of samples taken.
+    /// @throws std::runtime_error if the configuration requests adaptive
+    /// sampling, progressive passes or checkpoints, if the scene cannot be
+    /// saved, or if a worker fails or returns a tile of the wrong size.
+    Size renderDistributed(Image& image) const;
+
+    /// @brief Renders a tile of a distributed render. Appends the sums of the
+    /// color samples of its pixels to `result`, three values per pixel.
+    void renderTile(
+        const Index tile, Sampler& sampler, std::vector<f64>& result
+    ) const;
+
+    /// @brief Builds the light list of the scene for next event estimation.
+    void buildLights();
+
+    /// @brief Takes `count` samples of the pixel (px, py), starting at sample
+    /// index `first`.
+    /// @returns The sum of the sample colors.
+    Vector3D renderPixel(
+        const Index px,
+        const Index py,
+        const Index first,
+        const Size count,
+        Sampler& sampler
+    ) const;
+
+    /// @brief Takes `count` samples, starting at sample index `first`, of
+    /// every pixel in [x0, x1) x [y0, y1) and adds them to the framebuffer.
+    /// The camera rays of each sample of a block of PACKET_SIZE x
+    /// PACKET_SIZE pixels are intersected as one packet. The sums are the
+    /// same as with renderPixel().
+    void renderPackets(
+        const Index x0,
+        const Index y0,
+        const Index x1,
+        const Index y1,
+        const Index first,
+        const Size count,
+        Sampler& sampler,
+        Framebuffer& framebuffer
+    ) const;
+
+    /// @brief Takes the given sample of the pixel (px, py).
+    Vector3D samplePixel(
+        const Index px, const Index py, const Index sample, Sampler& sampler
+    ) const;
+
     /// @brief Generates a ray from the camera origin to the given pixel
     /// coordinates in worldspace.
-    Ray generate(const Index px, const Index py) const;
+    Ray generate(const Index px, const Index py, Sampler& sampler) const;
+
+    /// @brief Determines the color along a camera ray with the configured
+    /// integrator, given the closest intersection of the camera ray.
+    Vector3D shade(
+        const Ray& ray, Option<SurfaceInteraction> hit, Sampler& sampler
+    ) const;
+
+    /// @brief Recursively determines the pixel color, given the closest
+    /// intersection of the ray.
+    Vector3D shadeRecursive(
+        const Ray& ray,
+        const Option<SurfaceInteraction>& hit,
+        const Size depth,
+        Sampler& sampler
+    ) const;
+
+    /// @brief Iteratively determines the pixel color. Carries the path
+    /// throughput through a loop and terminates paths with Russian roulette
+    /// after Config::rouletteDepth bounces.
+    Vector3D shadeIterative(
+        const Ray& ray, Option<SurfaceInteraction> hit, Sampler& sampler
+    ) const;
 
-    /// @brief Recursively determines the pixel color.
-    Vector3D shadeRecursive(const Ray& ray, const Size depth) const;
+    /// @brief Iteratively determines the pixel color with next event
+    /// estimation. Lambertian hits trace a shadow ray to a sampled emitter,
+    /// and the light and BSDF samples are combined with multiple importance
+    /// sampling.
+    Vector3D shadeNextEvent(
+        const Ray& ray, Option<SurfaceInteraction> hit, Sampler& sampler
+    ) const;
+
+    /// @brief Estimates the direct light reflected at a Lambertian hit from a
+    /// single emitter sample, weighted against BSDF sampling.
+    Vector3D sampleDirect(
+        const SurfaceInteraction& interaction,
+        const Lambertian& lambertian,
+        Sampler& sampler
+    ) const;
+
+    /// @brief Creates a sampler of the configured sampling kind. Each render
+    /// thread owns one.
+    SamplerPtr makeSampler() const;
 
     /// @brief Background color given a ray.
     Vector3D background(const Ray& ray) const;
 
     std::unique_ptr<SpatialStructure> mWorld;
+
+    // Primitives of the scene, which distributed renders send to their
+    // workers.
+    std::vector<PrimitivePtr> mPrimitives;
+
+    LightList mLights;
     const Camera& mCamera;
+
+    // Hash of the scene content for checkpoints. Only computed when the
+    // render writes or resumes a checkpoint.
+    u64 mSceneHash;
 };
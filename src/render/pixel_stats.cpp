@@ -0,0 +1,44 @@
+#include "pixel_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/math/constants.hpp"
+
+namespace {
+
+/// @brief Luminance below which the relative error is measured against this
+/// floor instead.
+constexpr f64 cLuminanceFloor = 1e-2;
+
+f64 luminance(const Vector3D& color) {
+    return 0.2126 * color.x + 0.7152 * color.y + 0.0722 * color.z;
+}
+
+}
+
+void PixelStats::add(const Vector3D& color) {
+    ++count;
+
+    const f64 inv_count = 1.0 / static_cast<f64>(count);
+    mean += (color - mean) * inv_count;
+
+    const f64 y = luminance(color);
+    const f64 delta = y - luminanceMean;
+    luminanceMean += delta * inv_count;
+    luminanceM2 += delta * (y - luminanceMean);
+}
+
+f64 PixelStats::variance() const {
+    if (count < 2)
+        return 0.0;
+    return luminanceM2 / static_cast<f64>(count - 1);
+}
+
+f64 PixelStats::relativeError() const {
+    if (count < 2)
+        return math::infinity<f64>();
+
+    const f64 standard_error = std::sqrt(variance() / static_cast<f64>(count));
+    return standard_error / std::max(luminanceMean, cLuminanceFloor);
+}
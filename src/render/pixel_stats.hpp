@@ -0,0 +1,24 @@
+#pragma once
+
+#include "common/math/vector.hpp"
+#include "common/prelude.hpp"
+
+/// @brief Running estimate of a pixel. Tracks the mean color and, with
+/// Welford's algorithm, the mean and variance of the sample luminance.
+struct PixelStats {
+    Vector3D mean = Vector3D::zero();
+    f64 luminanceMean = 0.0;
+    f64 luminanceM2 = 0.0;
+    Size count = 0;
+
+    /// @brief Adds a sample to the estimate.
+    void add(const Vector3D& color);
+
+    /// @brief Computes the unbiased sample variance of the luminance.
+    f64 variance() const;
+
+    /// @brief Computes the standard error of the mean luminance relative to
+    /// the mean luminance. Dark pixels are measured against a small floor so
+    /// that they can converge.
+    f64 relativeError() const;
+};
@@ -13,23 +13,10 @@ Option<SurfaceInteraction> PrimList::intersect(const Ray& ray) const {
     Interval bounds(0.001, math::infinity<f64>());
 
     for (const PrimitivePtr& primitive : mPrimitives) {
-        const Transform& object_to_world = primitive->objectToWorld();
-        const Transform world_to_object = invert(object_to_world);
-
-        // Transform the ray with the primitive's world to object
-        // transformation.
-        const Ray inverse_ray = world_to_object(ray);
-
-        // Compute the surface interaction with the current primitive.
-        if (const Option<SurfaceInteraction> interaction =
-                primitive->intersect(inverse_ray, bounds)) {
+        if (Option<SurfaceInteraction> interaction =
+                primitive->intersectWorld(ray, bounds)) {
             if (!closest || interaction->t < closest->t) {
-                closest = interaction;
-
-                closest->p = object_to_world(interaction->p);
-                closest->n = (object_to_world(interaction->n)).normalize();
-                closest->mat = primitive->material();
-
+                closest = std::move(interaction);
                 bounds.max = std::min(closest->t, bounds.max);
             }
         }
@@ -37,3 +24,14 @@ Option<SurfaceInteraction> PrimList::intersect(const Ray& ray) const {
 
     return closest;
 }
+
+bool PrimList::occluded(const Ray& ray, const f64 tmax) const {
+    const Interval bounds(0.001, tmax);
+
+    for (const PrimitivePtr& primitive : mPrimitives) {
+        if (primitive->occludedWorld(ray, bounds))
+            return true;
+    }
+
+    return false;
+}
@@ -11,6 +11,8 @@ public:
 
     Option<SurfaceInteraction> intersect(const Ray& ray) const override;
 
+    bool occluded(const Ray& ray, const f64 tmax) const override;
+
 private:
     std::vector<PrimitivePtr> mPrimitives;
 };
@@ -1,12 +1,18 @@
 #include "cuboid_prim.hpp"
 
+#include <algorithm>
+
 CuboidPrim::CuboidPrim(
     const Point3D& o,
     const Vector3D& x,
     const Vector3D& y,
     const Vector3D& z
 )
-    : mQuads(
+    : mOrigin(o),
+      mX(x),
+      mY(y),
+      mZ(z),
+      mQuads(
           {// Front face.
            QuadPrim(o, y, x),
 
@@ -65,3 +71,56 @@ Option<SurfaceInteraction> CuboidPrim::intersect(
     }
     return closest;
 }
+
+bool CuboidPrim::occluded(const Ray& ray, const Interval& bounds) const {
+    for (const QuadPrim& quad : mQuads) {
+        if (quad.occluded(ray, bounds))
+            return true;
+    }
+    return false;
+}
+
+f64 CuboidPrim::area() const {
+    f64 total = 0.0;
+    for (const QuadPrim& quad : mQuads)
+        total += quad.area();
+    return total;
+}
+
+Option<SurfaceSample> CuboidPrim::sample(const f64 u1, const f64 u2) const {
+    // Select a face proportionally to its area, then rescale u1 so it can be
+    // reused to sample the face.
+    const f64 target = u1 * area();
+
+    f64 accumulated = 0.0;
+    for (const QuadPrim& quad : mQuads) {
+        const f64 face = quad.area();
+        if (face <= 0.0)
+            continue;
+
+        if (target < accumulated + face || &quad == &mQuads.back()) {
+            const f64 u = std::clamp((target - accumulated) / face, 0.0, 1.0);
+            return quad.sample(u, u2);
+        }
+
+        accumulated += face;
+    }
+
+    return std::nullopt;
+}
+
+void CuboidPrim::saveShape(BinaryWriter& writer) const {
+    writer.write(Shape::Cuboid);
+    writer.writeXYZ(mOrigin);
+    writer.writeXYZ(mX);
+    writer.writeXYZ(mY);
+    writer.writeXYZ(mZ);
+}
+
+std::shared_ptr<CuboidPrim> CuboidPrim::loadShape(BinaryReader& reader) {
+    const Point3D o = reader.readXYZ<Point3D>();
+    const Vector3D x = reader.readXYZ<Vector3D>();
+    const Vector3D y = reader.readXYZ<Vector3D>();
+    const Vector3D z = reader.readXYZ<Vector3D>();
+    return std::make_shared<CuboidPrim>(o, x, y, z);
+}
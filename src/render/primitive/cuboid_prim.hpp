@@ -24,6 +24,25 @@ public:
         const Ray& ray, const Interval& bounds
     ) const override;
 
+    /// @brief Determines whether the ray hits the cuboid within the parameter
+    /// bounds.
+    bool occluded(const Ray& ray, const Interval& bounds) const override;
+
+    /// @brief Computes the object space surface area of the cuboid faces.
+    f64 area() const override;
+
+    /// @brief Samples a point uniformly by area on the cuboid faces.
+    Option<SurfaceSample> sample(const f64 u1, const f64 u2) const override;
+
+    /// @brief Writes the shape and parameters of the cuboid.
+    void saveShape(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by saveShape() after the shape.
+    static std::shared_ptr<CuboidPrim> loadShape(BinaryReader& reader);
+
 private:
+    Point3D mOrigin;
+    Vector3D mX, mY, mZ;
+
     std::array<QuadPrim, 6> mQuads;
 };
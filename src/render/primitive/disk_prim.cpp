@@ -20,6 +20,45 @@ DiskPrim::DiskPrim(const Point3D& Q, const Vector3D& u, const Vector3D& v)
 
 Option<SurfaceInteraction> DiskPrim::intersect(
     const Ray& ray, const Interval& bounds
+) const {
+    const Option<f64> hit = hitParameter(ray, bounds);
+    if (!hit)
+        return std::nullopt;
+
+    const f64 t = *hit;
+    const Point3D P = ray.at(t);
+
+    if (ray.direction.dot(mNormal) > 0.0)
+        return SurfaceInteraction(
+            P, -mNormal, SurfaceInteraction::Face::Inside, t
+        );
+    else
+        return SurfaceInteraction(
+            P, mNormal, SurfaceInteraction::Face::Outside, t
+        );
+}
+
+bool DiskPrim::occluded(const Ray& ray, const Interval& bounds) const {
+    return hitParameter(ray, bounds).has_value();
+}
+
+f64 DiskPrim::area() const {
+    return math::pi<f64>() * mU.cross(mV).length();
+}
+
+Option<SurfaceSample> DiskPrim::sample(const f64 u1, const f64 u2) const {
+    // Uniformly sample the unit disk and map it onto the disk frame.
+    const f64 r = std::sqrt(u1);
+    const f64 phi = 2.0 * math::pi<f64>() * u2;
+
+    const f64 alpha = r * std::cos(phi);
+    const f64 beta = r * std::sin(phi);
+
+    return SurfaceSample{mQ + alpha * mU + beta * mV, mNormal};
+}
+
+Option<f64> DiskPrim::hitParameter(
+    const Ray& ray, const Interval& bounds
 ) const {
     const f64 denom = mNormal.dot(ray.direction);
 
@@ -32,8 +71,7 @@ Option<SurfaceInteraction> DiskPrim::intersect(
     if (!bounds.contains(t))
         return std::nullopt;
 
-    const Point3D P = ray.at(t);
-    const Vector3D p = P - mQ;
+    const Vector3D p = ray.at(t) - mQ;
 
     // Local frame canonical barycentric coordinate test.
     const f64 uu = mU.dot(mU);
@@ -50,12 +88,19 @@ Option<SurfaceInteraction> DiskPrim::intersect(
     if (almost::g(math::sqr(alpha) + math::sqr(beta), 1.0))
         return std::nullopt;
 
-    if (ray.direction.dot(mNormal) > 0.0)
-        return SurfaceInteraction(
-            P, -mNormal, SurfaceInteraction::Face::Inside, t
-        );
-    else
-        return SurfaceInteraction(
-            P, mNormal, SurfaceInteraction::Face::Outside, t
-        );
+    return t;
+}
+
+void DiskPrim::saveShape(BinaryWriter& writer) const {
+    writer.write(Shape::Disk);
+    writer.writeXYZ(mQ);
+    writer.writeXYZ(mU);
+    writer.writeXYZ(mV);
+}
+
+std::shared_ptr<DiskPrim> DiskPrim::loadShape(BinaryReader& reader) {
+    const Point3D Q = reader.readXYZ<Point3D>();
+    const Vector3D u = reader.readXYZ<Vector3D>();
+    const Vector3D v = reader.readXYZ<Vector3D>();
+    return std::make_shared<DiskPrim>(Q, u, v);
 }
@@ -16,7 +16,27 @@ public:
         const Ray& ray, const Interval& bounds
     ) const override;
 
+    /// @brief Determines whether the ray hits the disk within the parameter
+    /// bounds.
+    bool occluded(const Ray& ray, const Interval& bounds) const override;
+
+    /// @brief Computes the object space surface area of the disk.
+    f64 area() const override;
+
+    /// @brief Samples a point uniformly by area on the disk.
+    Option<SurfaceSample> sample(const f64 u1, const f64 u2) const override;
+
+    /// @brief Writes the shape and parameters of the disk.
+    void saveShape(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by saveShape() after the shape.
+    static std::shared_ptr<DiskPrim> loadShape(BinaryReader& reader);
+
 private:
+    /// @brief Computes the ray parameter of the hit with the disk within the
+    /// parameter bounds, if any.
+    Option<f64> hitParameter(const Ray& ray, const Interval& bounds) const;
+
     Point3D mQ;
     Vector3D mU, mV;
 
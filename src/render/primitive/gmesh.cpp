@@ -0,0 +1,159 @@
+#include "gmesh.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "common/util/binary_io.hpp"
+#include "common/util/mapped_file.hpp"
+
+namespace {
+
+constexpr u32 cMagic = 0x48534d47;  // "GMSH"
+
+/// @brief Fixed-size file header.
+struct Header {
+    u32 magic;
+    u32 version;
+    u32 flags;
+    u32 reserved;
+    u64 vertexCount;
+    u64 triangleCount;
+};
+
+static_assert(sizeof(Header) == 32, "Header must have no padding");
+
+/// @brief Reads an array of `count` elements.
+/// @throws std::runtime_error if the array has a different length.
+template <typename T>
+std::vector<T> readArray(BinaryReader& reader, const Size count) {
+    std::vector<T> values = reader.readVector<T>();
+    if (values.size() != count)
+        throw std::runtime_error("gmesh array has the wrong length");
+    return values;
+}
+
+}
+
+namespace gmesh {
+
+void save(BinaryWriter& writer, const MeshPrim& prim) {
+    const std::vector<Vertex>& vertices = prim.mesh().vertices();
+    const std::vector<TriangleMesh::Tri>& triangles = prim.mesh().triangles();
+
+    if (vertices.size() > std::numeric_limits<u32>::max())
+        throw std::runtime_error("too many vertices for a gmesh");
+
+    Header header{cMagic, VERSION, 0, 0, vertices.size(), triangles.size()};
+
+    std::vector<f64> positions;
+    std::vector<f64> normals;
+    std::vector<f64> texture;
+    positions.reserve(3 * vertices.size());
+
+    for (const Vertex& v : vertices) {
+        positions.insert(std::end(positions), {v.p.x, v.p.y, v.p.z});
+        normals.insert(std::end(normals), {v.n.x, v.n.y, v.n.z});
+        texture.insert(std::end(texture), {v.uv.x, v.uv.y});
+
+        if (v.n.x != 0.0 || v.n.y != 0.0 || v.n.z != 0.0)
+            header.flags |= HAS_NORMALS;
+        if (v.uv.x != 0.0 || v.uv.y != 0.0)
+            header.flags |= HAS_TEXTURE;
+    }
+
+    std::vector<u32> indices;
+    indices.reserve(3 * triangles.size());
+    for (const TriangleMesh::Tri& tri : triangles) {
+        indices.push_back(static_cast<u32>(tri.a));
+        indices.push_back(static_cast<u32>(tri.b));
+        indices.push_back(static_cast<u32>(tri.c));
+    }
+
+    writer.write(header);
+    writer.writeVector(positions);
+    if (header.flags & HAS_NORMALS)
+        writer.writeVector(normals);
+    if (header.flags & HAS_TEXTURE)
+        writer.writeVector(texture);
+    writer.writeVector(indices);
+    prim.save(writer);
+}
+
+std::unique_ptr<MeshPrim> load(BinaryReader& reader) {
+    const Header header = reader.read<Header>();
+    if (header.magic != cMagic || header.version != VERSION)
+        throw std::runtime_error("not a gmesh");
+
+    const Size vertex_count = header.vertexCount;
+    const Size triangle_count = header.triangleCount;
+
+    // Bound the counts by the file size before allocating anything.
+    if (vertex_count > reader.remaining() / (3 * sizeof(f64)) ||
+        triangle_count > reader.remaining() / (3 * sizeof(u32)))
+        throw std::runtime_error("gmesh file is truncated");
+
+    const std::vector<f64> positions =
+        readArray<f64>(reader, 3 * vertex_count);
+    const std::vector<f64> normals =
+        (header.flags & HAS_NORMALS) ? readArray<f64>(reader, 3 * vertex_count)
+                                     : std::vector<f64>();
+    const std::vector<f64> texture =
+        (header.flags & HAS_TEXTURE) ? readArray<f64>(reader, 2 * vertex_count)
+                                     : std::vector<f64>();
+    const std::vector<u32> indices =
+        readArray<u32>(reader, 3 * triangle_count);
+
+    std::vector<Vertex> vertices(vertex_count);
+    for (Index i = 0; i < vertex_count; ++i) {
+        Vertex& v = vertices[i];
+        v.p = Point3D(
+            positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]
+        );
+        if (!normals.empty())
+            v.n = Normal3D(
+                normals[3 * i], normals[3 * i + 1], normals[3 * i + 2]
+            );
+        if (!texture.empty())
+            v.uv = Point2D(texture[2 * i], texture[2 * i + 1]);
+    }
+
+    std::vector<TriangleMesh::Tri> triangles(triangle_count);
+    for (Index i = 0; i < triangle_count; ++i) {
+        const u32 a = indices[3 * i];
+        const u32 b = indices[3 * i + 1];
+        const u32 c = indices[3 * i + 2];
+        if (a >= vertex_count || b >= vertex_count || c >= vertex_count)
+            throw std::runtime_error("gmesh triangle has an invalid vertex");
+        triangles[i] = TriangleMesh::Tri{a, b, c};
+    }
+
+    return std::make_unique<MeshPrim>(
+        std::make_shared<const TriangleMesh>(
+            std::move(vertices), std::move(triangles)
+        ),
+        reader
+    );
+}
+
+void write(const char* path, const MeshPrim& prim) {
+    BinaryWriter writer(path);
+    save(writer, prim);
+    writer.commit();
+}
+
+std::unique_ptr<MeshPrim> read(const char* path) {
+    const MappedFile file(path);
+    BinaryReader reader(file.bytes());
+
+    try {
+        return load(reader);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(
+            "invalid gmesh file " + std::string(path) + ": " + e.what()
+        );
+    }
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+
+#include "common/prelude.hpp"
+#include "mesh_prim.hpp"
+
+/// @brief Compact binary mesh format. A .gmesh file holds a triangle mesh and
+/// the prebuilt acceleration data of its MeshPrim, so loading it maps the
+/// file and copies flat arrays instead of parsing text and building a BVH.
+///
+/// Layout, in native byte order:
+///   u32 magic "GMSH", u32 version, u32 flags, u32 reserved,
+///   u64 vertex count, u64 triangle count,
+///   f64 positions (x, y, z per vertex),
+///   f64 normals (x, y, z per vertex) if flags has HAS_NORMALS,
+///   f64 texture coordinates (u, v per vertex) if flags has HAS_TEXTURE,
+///   u32 indices (a, b, c per triangle),
+///   MeshPrim acceleration data as written by MeshPrim::save().
+/// Every array is prefixed with its u64 length.
+namespace gmesh {
+
+/// @brief Version of the layout. Files of other versions are rejected.
+constexpr u32 VERSION = 1;
+
+/// @brief The vertices have normals.
+constexpr u32 HAS_NORMALS = 1 << 0;
+
+/// @brief The vertices have texture coordinates.
+constexpr u32 HAS_TEXTURE = 1 << 1;
+
+/// @brief Writes the mesh of the primitive and its acceleration data in the
+/// .gmesh layout. Normals and texture coordinates are omitted if every vertex
+/// has zero ones.
+/// @throws std::runtime_error if the mesh has too many vertices for 32-bit
+/// indices.
+void save(BinaryWriter& writer, const MeshPrim& prim);
+
+/// @brief Reads a mesh primitive written by save().
+/// @throws std::runtime_error if the data is malformed.
+std::unique_ptr<MeshPrim> load(BinaryReader& reader);
+
+/// @brief Writes the primitive to a .gmesh file with save().
+/// @throws std::runtime_error if the file cannot be written or the mesh has
+/// too many vertices for 32-bit indices.
+void write(const char* path, const MeshPrim& prim);
+
+/// @brief Reads a mesh primitive from a .gmesh file.
+/// @throws std::runtime_error if the file cannot be read or is malformed.
+std::unique_ptr<MeshPrim> read(const char* path);
+
+}
@@ -0,0 +1,89 @@
+#include "mesh_asset_cache.hpp"
+
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "common/geometry/obj_mesh_reader.hpp"
+#include "common/util/log.hpp"
+#include "gmesh.hpp"
+
+namespace {
+
+/// @brief Cached asset with the state of the file it was loaded from.
+struct CacheEntry {
+    std::filesystem::file_time_type modified;
+    std::uintmax_t size;
+    std::weak_ptr<const MeshAsset> asset;
+};
+
+std::mutex cacheMutex;
+std::map<std::string, CacheEntry> cacheEntries;
+
+MeshAssetPtr loadAsset(const std::filesystem::path& path) {
+    if (path.extension() == ".gmesh")
+        return std::make_shared<const MeshAsset>(
+            gmesh::read(path.string().c_str())
+        );
+    return std::make_shared<const MeshAsset>(
+        std::make_shared<const TriangleMesh>(
+            ObjMeshReader().read(path.string().c_str())
+        )
+    );
+}
+
+}
+
+MeshAsset::MeshAsset(std::shared_ptr<const TriangleMesh> mesh)
+    : mMesh(std::move(mesh)), mPrimitiveFlag(), mPrimitive(nullptr) {
+}
+
+MeshAsset::MeshAsset(std::unique_ptr<const MeshPrim> primitive)
+    : mMesh(primitive->sharedMesh()),
+      mPrimitiveFlag(),
+      mPrimitive(std::move(primitive)) {
+}
+
+const std::shared_ptr<const TriangleMesh>& MeshAsset::mesh() const {
+    return mMesh;
+}
+
+const MeshPrim& MeshAsset::primitive() const {
+    std::call_once(mPrimitiveFlag, [this]() {
+        if (!mPrimitive)
+            mPrimitive = std::make_unique<const MeshPrim>(mMesh);
+    });
+    return *mPrimitive;
+}
+
+MeshAssetPtr MeshAssetCache::load(const char* path) {
+    std::error_code error;
+    const std::filesystem::path canonical =
+        std::filesystem::canonical(path, error);
+    if (error)
+        throw std::runtime_error(
+            "could not open mesh file " + std::string(path) + ": " +
+            error.message()
+        );
+
+    const std::filesystem::file_time_type modified =
+        std::filesystem::last_write_time(canonical);
+    const std::uintmax_t size = std::filesystem::file_size(canonical);
+
+    // Loads run under the lock so that concurrent requests for one file parse
+    // it once.
+    const std::lock_guard<std::mutex> lock(cacheMutex);
+
+    CacheEntry& entry = cacheEntries[canonical.string()];
+    if (entry.modified == modified && entry.size == size) {
+        if (MeshAssetPtr asset = entry.asset.lock()) {
+            Log::d("Reusing mesh {}", canonical.string());
+            return asset;
+        }
+    }
+
+    MeshAssetPtr asset = loadAsset(canonical);
+    entry = CacheEntry{modified, size, asset};
+    return asset;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "common/geometry/triangle_mesh.hpp"
+#include "mesh_prim.hpp"
+
+/// @brief Immutable mesh loaded from a file, shared by every node that
+/// references the file. The prototype primitive, and with it the triangle
+/// BVH, is built at most once and copied into each instance.
+class MeshAsset {
+public:
+    MeshAsset(std::shared_ptr<const TriangleMesh> mesh);
+
+    /// @brief Creates the asset with a primitive loaded with the mesh.
+    MeshAsset(std::unique_ptr<const MeshPrim> primitive);
+
+    /// @brief Retrieves the shared object space mesh.
+    const std::shared_ptr<const TriangleMesh>& mesh() const;
+
+    /// @brief Retrieves the prototype primitive, building it on first use.
+    /// Safe to call from several threads.
+    const MeshPrim& primitive() const;
+
+private:
+    std::shared_ptr<const TriangleMesh> mMesh;
+    mutable std::once_flag mPrimitiveFlag;
+    mutable std::unique_ptr<const MeshPrim> mPrimitive;
+};
+
+using MeshAssetPtr = std::shared_ptr<const MeshAsset>;
+
+/// @brief Process-wide cache of mesh files. Files are keyed by canonical path
+/// and reloaded when their modification time or size changes. The cache
+/// holds weak references, so assets are released with their last user.
+class MeshAssetCache {
+public:
+    /// @brief Retrieves the asset of a Wavefront .obj or .gmesh file, loading
+    /// it if it is not cached or has changed on disk.
+    /// @throws std::runtime_error if the file cannot be read or parsed.
+    static MeshAssetPtr load(const char* path);
+};
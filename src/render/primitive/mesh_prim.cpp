@@ -1,44 +1,271 @@
 #include "mesh_prim.hpp"
 
-#include "triangle_prim.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
 
-MeshPrim::MeshPrim(const TriangleMesh& mesh) : mMesh(mesh) {
+MeshPrim::MeshPrim(TriangleMesh mesh)
+    : MeshPrim(std::make_shared<const TriangleMesh>(std::move(mesh))) {
+}
+
+MeshPrim::MeshPrim(std::shared_ptr<const TriangleMesh> mesh)
+    : mMesh(std::move(mesh)), mAcceleration() {
     mKind = Kind::Mesh;
 
-    if (mMesh.vertices().empty())
+    auto acceleration = std::make_shared<Acceleration>();
+    mAcceleration = acceleration;
+
+    if (mMesh->vertices().empty())
         return;
 
-    Point3D min = mMesh.vertices().front().p;
-    Point3D max = mMesh.vertices().front().p;
+    computeBounds();
 
-    for (Index i = 1; i < mMesh.vertices().size(); ++i) {
-        const Point3D& p = mMesh.vertices()[i].p;
-        min = min.min(p);
-        max = max.max(p);
+    // Build the bottom-level BVH over the object space triangle bounds.
+    std::vector<BuildRef> refs;
+    refs.reserve(mMesh->triangles().size());
+
+    for (Index i = 0; i < mMesh->triangles().size(); ++i) {
+        const TriangleMesh::Tri& tri = mMesh->triangles()[i];
+        const Point3D& Q = mMesh->vertices()[tri.a].p;
+        const Point3D& R = mMesh->vertices()[tri.b].p;
+        const Point3D& S = mMesh->vertices()[tri.c].p;
+
+        const AABB bbox(Q.min(R).min(S), Q.max(R).max(S));
+        refs.push_back(BuildRef{bbox, bbox.centroid(), i});
     }
 
-    mBbox = AABB(min, max);
+    acceleration->tree.build(std::move(refs), SAHParams(), MAX_LEAF_SIZE);
+    buildBlocks(*acceleration);
+
+    acceleration->areaCdf.reserve(mMesh->triangles().size());
+
+    f64 total = 0.0;
+    for (Index i = 0; i < mMesh->triangles().size(); ++i) {
+        total += triangle(i).area();
+        acceleration->areaCdf.push_back(total);
+    }
+}
+
+MeshPrim::MeshPrim(
+    std::shared_ptr<const TriangleMesh> mesh, BinaryReader& reader
+)
+    : mMesh(std::move(mesh)), mAcceleration() {
+    mKind = Kind::Mesh;
+
+    auto acceleration = std::make_shared<Acceleration>();
+    acceleration->tree.load(reader);
+    acceleration->areaCdf = reader.readVector<f64>();
+
+    if (acceleration->areaCdf.size() != mMesh->triangles().size())
+        throw std::runtime_error("mesh acceleration data does not match mesh");
+    for (const Index item : acceleration->tree.items())
+        if (item >= mMesh->triangles().size())
+            throw std::runtime_error("mesh BVH references a missing triangle");
+
+    buildBlocks(*acceleration);
+    mAcceleration = std::move(acceleration);
+
+    if (!mMesh->vertices().empty())
+        computeBounds();
+}
+
+const TriangleMesh& MeshPrim::mesh() const {
+    return *mMesh;
+}
+
+const std::shared_ptr<const TriangleMesh>& MeshPrim::sharedMesh() const {
+    return mMesh;
+}
+
+void MeshPrim::save(BinaryWriter& writer) const {
+    mAcceleration->tree.save(writer);
+    writer.writeVector(mAcceleration->areaCdf);
 }
 
 Option<SurfaceInteraction> MeshPrim::intersect(
     const Ray& ray, const Interval& bounds
 ) const {
-    Option<SurfaceInteraction> closest = std::nullopt;
+    const BVHTree& tree = mAcceleration->tree;
+    const TriangleRay triangle_ray(ray);
 
-    for (const TriangleMesh::Tri& tri : mMesh.triangles()) {
-        const Point3D& Q = mMesh.vertices()[tri.a].p;
-        const Point3D& R = mMesh.vertices()[tri.b].p;
-        const Point3D& S = mMesh.vertices()[tri.c].p;
+    Option<Index> closest = std::nullopt;
+    f64 t = bounds.max;
+    Interval search = bounds;
 
-        const Vector3D u = R - Q;
-        const Vector3D v = S - Q;
+    tree.traverseLeaves(
+        ray,
+        search,
+        [&](const LinearBVHNode& leaf, Interval& search) {
+            const Option<BlockHit> hit =
+                triangle_ray.intersect(block(leaf), search);
+            if (!hit)
+                return false;
 
-        if (const Option<SurfaceInteraction> i =
-                TrianglePrim(Q, u, v).intersect(ray, bounds)) {
-            if (!closest || i->t < closest->t)
-                closest = i;
+            t = hit->t;
+            search.max = t;
+            closest = tree.items()[leaf.itemOffset + hit->lane];
+            return true;
         }
+    );
+
+    if (!closest)
+        return std::nullopt;
+
+    return interaction(ray, t, *closest);
+}
+
+bool MeshPrim::occluded(const Ray& ray, const Interval& bounds) const {
+    const BVHTree& tree = mAcceleration->tree;
+    const TriangleRay triangle_ray(ray);
+
+    return tree.traverseAnyLeaves(ray, bounds, [&](const LinearBVHNode& leaf) {
+        return triangle_ray.intersect(block(leaf), bounds).has_value();
+    });
+}
+
+u64 MeshPrim::intersectPacket(
+    std::span<const Ray> rays,
+    const u64 mask,
+    std::span<Interval> bounds,
+    std::span<Option<SurfaceInteraction>> hits
+) const {
+    const BVHTree& tree = mAcceleration->tree;
+
+    Option<TriangleRay> triangle_rays[BVHTree::MAX_PACKET];
+    Option<Index> closest[BVHTree::MAX_PACKET];
+    for (u64 bits = mask; bits != 0; bits &= bits - 1) {
+        const Index i = std::countr_zero(bits);
+        triangle_rays[i].emplace(rays[i]);
     }
 
-    return closest;
+    tree.traversePacket(
+        rays,
+        mask,
+        bounds,
+        [&](const LinearBVHNode& leaf, const u64 leaf_mask) {
+            const TriangleBlock& leaf_block = block(leaf);
+            for (u64 bits = leaf_mask; bits != 0; bits &= bits - 1) {
+                const Index i = std::countr_zero(bits);
+                const Option<BlockHit> hit =
+                    triangle_rays[i]->intersect(leaf_block, bounds[i]);
+                if (!hit)
+                    continue;
+
+                bounds[i].max = hit->t;
+                closest[i] = tree.items()[leaf.itemOffset + hit->lane];
+            }
+        }
+    );
+
+    u64 hit_mask = 0;
+    for (u64 bits = mask; bits != 0; bits &= bits - 1) {
+        const Index i = std::countr_zero(bits);
+        if (!closest[i])
+            continue;
+
+        hits[i] = interaction(rays[i], bounds[i].max, *closest[i]);
+        hit_mask |= u64(1) << i;
+    }
+    return hit_mask;
+}
+
+f64 MeshPrim::area() const {
+    const std::vector<f64>& cdf = mAcceleration->areaCdf;
+    return cdf.empty() ? 0.0 : cdf.back();
+}
+
+Option<SurfaceSample> MeshPrim::sample(const f64 u1, const f64 u2) const {
+    const std::vector<f64>& cdf = mAcceleration->areaCdf;
+
+    const f64 total = area();
+    if (total <= 0.0)
+        return std::nullopt;
+
+    // Select a triangle proportionally to its area, then rescale u1 so it can
+    // be reused to sample the triangle.
+    const f64 target = u1 * total;
+    const auto it = std::upper_bound(std::begin(cdf), std::end(cdf), target);
+    const Index index =
+        std::min<Index>(std::distance(std::begin(cdf), it), cdf.size() - 1);
+
+    const f64 lower = (index == 0) ? 0.0 : cdf[index - 1];
+    const f64 face = cdf[index] - lower;
+    const f64 u = std::clamp((target - lower) / face, 0.0, 1.0);
+
+    return triangle(index).sample(u, u2);
+}
+
+void MeshPrim::computeBounds() {
+    const std::vector<Vertex>& vertices = mMesh->vertices();
+
+    Point3D min = vertices.front().p;
+    Point3D max = vertices.front().p;
+
+    for (Index i = 1; i < vertices.size(); ++i) {
+        const Point3D& p = vertices[i].p;
+        min = min.min(p);
+        max = max.max(p);
+    }
+
+    mBbox = AABB(min, max);
+}
+
+void MeshPrim::buildBlocks(Acceleration& acceleration) const {
+    const std::vector<LinearBVHNode>& nodes = acceleration.tree.nodes();
+    const std::vector<Index>& items = acceleration.tree.items();
+
+    acceleration.leafBlocks.assign(nodes.size(), 0);
+
+    for (Index i = 0; i < nodes.size(); ++i) {
+        const LinearBVHNode& node = nodes[i];
+        if (!node.isLeaf())
+            continue;
+        if (node.itemCount > TriangleBlock::WIDTH)
+            throw std::runtime_error("mesh BVH leaf does not fit in a block");
+
+        TriangleBlock block;
+        for (Index lane = 0; lane < node.itemCount; ++lane)
+            block.set(lane, record(items[node.itemOffset + lane]));
+
+        acceleration.leafBlocks[i] = acceleration.blocks.size();
+        acceleration.blocks.push_back(block);
+    }
+}
+
+const TriangleBlock& MeshPrim::block(const LinearBVHNode& leaf) const {
+    const Index node = &leaf - mAcceleration->tree.nodes().data();
+    return mAcceleration->blocks[mAcceleration->leafBlocks[node]];
+}
+
+TriangleRecord MeshPrim::record(const Index index) const {
+    const TriangleMesh::Tri& tri = mMesh->triangles()[index];
+    return TriangleRecord{
+        mMesh->vertices()[tri.a].p,
+        mMesh->vertices()[tri.b].p,
+        mMesh->vertices()[tri.c].p,
+    };
+}
+
+SurfaceInteraction MeshPrim::interaction(
+    const Ray& ray, const f64 t, const Index index
+) const {
+    const Normal3D normal = record(index).normal();
+
+    if (ray.direction.dot(normal) > 0.0)
+        return SurfaceInteraction(
+            ray.at(t), -normal, SurfaceInteraction::Face::Inside, t
+        );
+    else
+        return SurfaceInteraction(
+            ray.at(t), normal, SurfaceInteraction::Face::Outside, t
+        );
+}
+
+TrianglePrim MeshPrim::triangle(const Index index) const {
+    const TriangleMesh::Tri& tri = mMesh->triangles()[index];
+    const Point3D& Q = mMesh->vertices()[tri.a].p;
+    const Point3D& R = mMesh->vertices()[tri.b].p;
+    const Point3D& S = mMesh->vertices()[tri.c].p;
+
+    return TrianglePrim(Q, R - Q, S - Q);
 }
@@ -1,19 +1,115 @@
 #pragma once
 
+#include <memory>
+
 #include "common/geometry/triangle_mesh.hpp"
 #include "primitive.hpp"
+#include "render/accel/bvh_tree.hpp"
+#include "triangle_kernel.hpp"
+#include "triangle_prim.hpp"
 
+/// @brief Triangle mesh primitive. Builds a bottom-level BVH over its
+/// triangles so that the intersection cost grows logarithmically with the
+/// triangle count. The mesh and the acceleration data are immutable and
+/// shared, so copies of a primitive, such as instances of one mesh with
+/// different materials or transforms, cost no more than the primitive
+/// itself.
 class MeshPrim : public Primitive {
 public:
-    MeshPrim(const TriangleMesh& mesh);
+    MeshPrim(TriangleMesh mesh);
+    MeshPrim(std::shared_ptr<const TriangleMesh> mesh);
+
+    /// @brief Creates the mesh primitive with acceleration data written by
+    /// save() instead of building it.
+    /// @throws std::runtime_error if the data does not match the mesh.
+    MeshPrim(std::shared_ptr<const TriangleMesh> mesh, BinaryReader& reader);
     ~MeshPrim() override = default;
 
-    /// @brief Computes the surface intersection with the mesh by computing
-    /// the intersection with all component triangles.
+    /// @brief Computes the surface intersection with the mesh by traversing
+    /// the triangle BVH. The triangles of each leaf are tested at once with
+    /// the watertight block kernel, and the interaction is built for the
+    /// closest hit only.
     Option<SurfaceInteraction> intersect(
         const Ray& ray, const Interval& bounds
     ) const override;
 
+    /// @brief Determines whether the ray hits the mesh within the parameter
+    /// bounds.
+    bool occluded(const Ray& ray, const Interval& bounds) const override;
+
+    /// @brief Computes the surface intersections of a packet of rays with the
+    /// mesh by traversing the triangle BVH once for the whole packet. Each
+    /// leaf is tested against the rays that enter it.
+    u64 intersectPacket(
+        std::span<const Ray> rays,
+        const u64 mask,
+        std::span<Interval> bounds,
+        std::span<Option<SurfaceInteraction>> hits
+    ) const override;
+
+    /// @brief Computes the object space surface area of the mesh triangles.
+    f64 area() const override;
+
+    /// @brief Samples a point uniformly by area on the mesh triangles.
+    Option<SurfaceSample> sample(const f64 u1, const f64 u2) const override;
+
+    /// @brief Retrieves a constant reference to the object space mesh.
+    const TriangleMesh& mesh() const;
+
+    /// @brief Retrieves the shared object space mesh.
+    const std::shared_ptr<const TriangleMesh>& sharedMesh() const;
+
+    /// @brief Writes the acceleration data, which is the triangle BVH and the
+    /// area distribution. The mesh itself is not written.
+    void save(BinaryWriter& writer) const;
+
 private:
-    TriangleMesh mMesh;
+    /// @brief Maximum number of triangles in a BVH leaf.
+    static constexpr Size MAX_LEAF_SIZE = 4;
+
+    /// @brief Acceleration data derived from the mesh.
+    struct Acceleration {
+        BVHTree tree;
+
+        // Cumulative triangle areas used to sample triangles by area.
+        std::vector<f64> areaCdf;
+
+        // Triangles of every BVH leaf packed into one block, so the ray is
+        // tested against the whole leaf at once.
+        std::vector<TriangleBlock> blocks;
+
+        // Index of the block of every leaf node, by node index.
+        std::vector<u32> leafBlocks;
+    };
+
+    static_assert(
+        MAX_LEAF_SIZE <= TriangleBlock::WIDTH,
+        "BVH leaves must fit in a triangle block"
+    );
+
+    /// @brief Packs the triangles of every leaf of the tree into blocks.
+    /// @throws std::runtime_error if a leaf does not fit in a block.
+    void buildBlocks(Acceleration& acceleration) const;
+
+    /// @brief Retrieves the triangle block of a leaf node.
+    const TriangleBlock& block(const LinearBVHNode& leaf) const;
+
+    /// @brief Retrieves the intersection record of the triangle at the given
+    /// index.
+    TriangleRecord record(const Index index) const;
+
+    /// @brief Builds the interaction of the ray with the triangle at the
+    /// given index, which it hits at parameter `t`.
+    SurfaceInteraction interaction(
+        const Ray& ray, const f64 t, const Index index
+    ) const;
+
+    /// @brief Computes the object space bounds of the mesh vertices.
+    void computeBounds();
+
+    /// @brief Retrieves the triangle at the given index.
+    TrianglePrim triangle(const Index index) const;
+
+    std::shared_ptr<const TriangleMesh> mMesh;
+    std::shared_ptr<const Acceleration> mAcceleration;
 };
@@ -1,8 +1,16 @@
 #include "primitive.hpp"
 
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+#include "render/accel/bvh_tree.hpp"
+
 Primitive::Primitive()
     : mKind(Primitive::Kind::Null),
       mObjectToWorld(),
+      mWorldToObject(),
+      mIdentityTransform(true),
       mMaterial(nullptr),
       mBbox() {
 }
@@ -10,6 +18,10 @@ Primitive::Primitive()
 Primitive::~Primitive() {
 }
 
+void Primitive::saveShape(BinaryWriter& writer) const {
+    throw std::runtime_error("primitive cannot be saved");
+}
+
 Primitive::Kind Primitive::kind() const {
     return mKind;
 }
@@ -20,6 +32,121 @@ const Transform& Primitive::objectToWorld() const {
 
 void Primitive::setObjectToWorld(const Transform& transform) {
     mObjectToWorld = transform;
+    mWorldToObject = invert(transform);
+    mIdentityTransform = transform.isIdentity();
+}
+
+const Transform& Primitive::worldToObject() const {
+    return mWorldToObject;
+}
+
+bool Primitive::hasIdentityTransform() const {
+    return mIdentityTransform;
+}
+
+Option<SurfaceInteraction> Primitive::intersectWorld(
+    const Ray& ray, const Interval& bounds
+) const {
+    // Object space and worldspace coincide, so skip both transformations.
+    if (mIdentityTransform) {
+        if (!mBbox.checkIntersect(ray, bounds))
+            return std::nullopt;
+
+        Option<SurfaceInteraction> interaction = intersect(ray, bounds);
+        if (interaction) {
+            interaction->mat = mMaterial;
+            interaction->prim = this;
+        }
+        return interaction;
+    }
+
+    const Ray object_ray = mWorldToObject(ray);
+
+    if (!mBbox.checkIntersect(object_ray, bounds))
+        return std::nullopt;
+
+    Option<SurfaceInteraction> interaction = intersect(object_ray, bounds);
+    if (!interaction)
+        return std::nullopt;
+
+    interaction->p = mObjectToWorld(interaction->p);
+    interaction->n = (mObjectToWorld(interaction->n)).normalize();
+    interaction->mat = mMaterial;
+    interaction->prim = this;
+
+    return interaction;
+}
+
+u64 Primitive::intersectPacket(
+    std::span<const Ray> rays,
+    const u64 mask,
+    std::span<Interval> bounds,
+    std::span<Option<SurfaceInteraction>> hits
+) const {
+    u64 hit_mask = 0;
+    for (u64 bits = mask; bits != 0; bits &= bits - 1) {
+        const Index i = std::countr_zero(bits);
+        Option<SurfaceInteraction> interaction = intersect(rays[i], bounds[i]);
+        if (!interaction)
+            continue;
+
+        bounds[i].max = interaction->t;
+        hits[i] = std::move(interaction);
+        hit_mask |= u64(1) << i;
+    }
+    return hit_mask;
+}
+
+u64 Primitive::intersectWorldPacket(
+    std::span<const Ray> rays,
+    const u64 mask,
+    std::span<Interval> bounds,
+    std::span<Option<SurfaceInteraction>> hits
+) const {
+    if (mIdentityTransform)
+        return intersectObjectPacket(rays, mask, bounds, hits);
+
+    assertm(rays.size() <= BVHTree::MAX_PACKET, "packet has too many rays");
+
+    // An affine transformation maps a shared origin to a shared origin, so a
+    // transformed packet stays coherent and is intersected as a whole in
+    // object space. Only the rays of the mask are transformed.
+    std::array<Ray, BVHTree::MAX_PACKET> object_rays;
+    for (u64 bits = mask; bits != 0; bits &= bits - 1) {
+        const Index i = std::countr_zero(bits);
+        object_rays[i] = mWorldToObject(rays[i]);
+    }
+
+    const u64 hit_mask = intersectObjectPacket(
+        std::span<const Ray>(object_rays).first(rays.size()),
+        mask,
+        bounds,
+        hits
+    );
+    for (u64 bits = hit_mask; bits != 0; bits &= bits - 1) {
+        const Index i = std::countr_zero(bits);
+        hits[i]->p = mObjectToWorld(hits[i]->p);
+        hits[i]->n = (mObjectToWorld(hits[i]->n)).normalize();
+    }
+    return hit_mask;
+}
+
+bool Primitive::occludedWorld(const Ray& ray, const Interval& bounds) const {
+    if (mIdentityTransform)
+        return mBbox.checkIntersect(ray, bounds) && occluded(ray, bounds);
+
+    const Ray object_ray = mWorldToObject(ray);
+
+    return mBbox.checkIntersect(object_ray, bounds) &&
+           occluded(object_ray, bounds);
+}
+
+f64 Primitive::area() const {
+    return 0.0;
+}
+
+Option<SurfaceSample> Primitive::sample(const f64 u1, const f64 u2) const {
+    return std::nullopt;
 }
 
 const MaterialPtr& Primitive::material() const {
@@ -33,3 +160,27 @@ void Primitive::setMaterial(const MaterialPtr& material) {
 const AABB& Primitive::aabb() const {
     return mBbox;
 }
+
+u64 Primitive::intersectObjectPacket(
+    std::span<const Ray> rays,
+    const u64 mask,
+    std::span<Interval> bounds,
+    std::span<Option<SurfaceInteraction>> hits
+) const {
+    u64 entered = 0;
+    for (u64 bits = mask; bits != 0; bits &= bits - 1) {
+        const Index i = std::countr_zero(bits);
+        if (mBbox.checkIntersect(rays[i], bounds[i]))
+            entered |= u64(1) << i;
+    }
+    if (entered == 0)
+        return 0;
+
+    const u64 hit_mask = intersectPacket(rays, entered, bounds, hits);
+    for (u64 bits = hit_mask; bits != 0; bits &= bits - 1) {
+        const Index i = std::countr_zero(bits);
+        hits[i]->mat = mMaterial;
+        hits[i]->prim = this;
+    }
+    return hit_mask;
+}
@@ -1,14 +1,23 @@
 #pragma once
 
+#include <span>
+
 #include "common/math/aabb.hpp"
 #include "common/math/interval.hpp"
 #include "common/math/matrix.hpp"
 #include "common/math/ray.hpp"
 #include "common/math/transform.hpp"
 #include "common/prelude.hpp"
+#include "common/util/binary_io.hpp"
 #include "render/material/material.hpp"
 #include "render/material/surface_interaction.hpp"
 
+/// @brief Point and unit normal sampled on the surface of a primitive.
+struct SurfaceSample {
+    Point3D p;
+    Normal3D n;
+};
+
 /// @brief Rendering primitive base class. Defines an interface for ray-surface
 /// intersections.
 class Primitive {
@@ -19,6 +28,18 @@ public:
         Mesh,
     };
 
+    /// @brief Shape of a primitive, which identifies its class in scene
+    /// snapshots.
+    enum class Shape : u32 {
+        Sphere = 0,
+        Quad,
+        Cuboid,
+        Tube,
+        Disk,
+        Triangle,
+        Mesh,
+    };
+
     Primitive();
     virtual ~Primitive();
 
@@ -28,15 +49,83 @@ public:
         const Ray& ray, const Interval& bounds
     ) const = 0;
 
+    /// @brief Determines whether the ray hits the primitive within the
+    /// specified parameter bounds. Returns at the first hit found without
+    /// building a surface interaction.
+    virtual bool occluded(const Ray& ray, const Interval& bounds) const = 0;
+
+    /// @brief Determines the closest intersections of the rays selected by
+    /// `mask` from a packet. A hit of ray i within `bounds[i]` is stored in
+    /// `hits[i]` and shrinks `bounds[i].max` to its parameter. The default
+    /// intersects the rays one at a time.
+    /// @returns The mask of the rays that were hit.
+    virtual u64 intersectPacket(
+        std::span<const Ray> rays,
+        const u64 mask,
+        std::span<Interval> bounds,
+        std::span<Option<SurfaceInteraction>> hits
+    ) const;
+
+    /// @brief Computes the object space surface area of the primitive. The
+    /// default of zero marks primitives that cannot be sampled.
+    virtual f64 area() const;
+
+    /// @brief Samples a point uniformly by area on the object space surface
+    /// from the canonical random numbers (u1, u2).
+    virtual Option<SurfaceSample> sample(const f64 u1, const f64 u2) const;
+
+    /// @brief Writes the shape of the primitive followed by the parameters it
+    /// was constructed with. The transform and material are not included.
+    /// Mesh primitives are saved by scene snapshots instead, which store the
+    /// data of instances once.
+    /// @throws std::runtime_error if the primitive cannot be saved, which is
+    /// the default.
+    virtual void saveShape(BinaryWriter& writer) const;
+
     /// @brief Retrieves the kind of the primitive.
     Kind kind() const;
 
     /// @brief Retrieves a constant reference to the object transform.
     const Transform& objectToWorld() const;
 
-    /// @brief Sets the object to world transform.
+    /// @brief Sets the object to world transform. Also caches the inverse
+    /// world to object transform.
     void setObjectToWorld(const Transform& transform);
 
+    /// @brief Retrieves a constant reference to the cached world to object
+    /// transform.
+    const Transform& worldToObject() const;
+
+    /// @brief Determines whether the object to world transform is the
+    /// identity.
+    bool hasIdentityTransform() const;
+
+    /// @brief Determines the closest intersection between a worldspace ray
+    /// and the primitive. The ray is transformed into object space unless the
+    /// transform is the identity, and the resulting interaction is returned
+    /// in worldspace with the primitive's material and a pointer to the
+    /// primitive.
+    Option<SurfaceInteraction> intersectWorld(
+        const Ray& ray, const Interval& bounds
+    ) const;
+
+    /// @brief Determines whether a worldspace ray hits the primitive within
+    /// the parameter bounds, transforming it into object space unless the
+    /// transform is the identity.
+    bool occludedWorld(const Ray& ray, const Interval& bounds) const;
+
+    /// @brief Determines the closest intersections of a packet of worldspace
+    /// rays with the primitive like intersectPacket(), completing the
+    /// interactions like intersectWorld(). The rays of primitives with a
+    /// transform are transformed into object space as a packet.
+    /// @returns The mask of the rays that were hit.
+    u64 intersectWorldPacket(
+        std::span<const Ray> rays,
+        const u64 mask,
+        std::span<Interval> bounds,
+        std::span<Option<SurfaceInteraction>> hits
+    ) const;
+
     /// @brief Retrieves a constant reference to the material pointer.
     const MaterialPtr& material() const;
 
@@ -50,8 +139,22 @@ public:
 protected:
     Kind mKind;
     Transform mObjectToWorld;
+    Transform mWorldToObject;
+    bool mIdentityTransform;
     MaterialPtr mMaterial;
     AABB mBbox;
+
+private:
+    /// @brief Tests a packet of object space rays against the bounding box,
+    /// intersects the rays that enter it with intersectPacket() and sets the
+    /// material and primitive of the hits.
+    /// @returns The mask of the rays that were hit.
+    u64 intersectObjectPacket(
+        std::span<const Ray> rays,
+        const u64 mask,
+        std::span<Interval> bounds,
+        std::span<Option<SurfaceInteraction>> hits
+    ) const;
 };
 
 using PrimitivePtr = std::shared_ptr<Primitive>;
@@ -17,6 +17,38 @@ QuadPrim::QuadPrim(const Point3D& Q, const Vector3D& u, const Vector3D& v)
 
 Option<SurfaceInteraction> QuadPrim::intersect(
     const Ray& ray, const Interval& bounds
+) const {
+    const Option<f64> hit = hitParameter(ray, bounds);
+    if (!hit)
+        return std::nullopt;
+
+    const f64 t = *hit;
+    const Point3D P = ray.at(t);
+
+    if (ray.direction.dot(mNormal) > 0.0)
+        return SurfaceInteraction(
+            P, -mNormal, SurfaceInteraction::Face::Inside, t
+        );
+    else
+        return SurfaceInteraction(
+            P, mNormal, SurfaceInteraction::Face::Outside, t
+        );
+}
+
+bool QuadPrim::occluded(const Ray& ray, const Interval& bounds) const {
+    return hitParameter(ray, bounds).has_value();
+}
+
+f64 QuadPrim::area() const {
+    return mU.cross(mV).length();
+}
+
+Option<SurfaceSample> QuadPrim::sample(const f64 u1, const f64 u2) const {
+    return SurfaceSample{mQ + u1 * mU + u2 * mV, mNormal};
+}
+
+Option<f64> QuadPrim::hitParameter(
+    const Ray& ray, const Interval& bounds
 ) const {
     const f64 denom = mNormal.dot(ray.direction);
 
@@ -29,8 +61,7 @@ Option<SurfaceInteraction> QuadPrim::intersect(
     if (!bounds.contains(t))
         return std::nullopt;
 
-    const Point3D P = ray.at(t);
-    const Vector3D p = P - mQ;
+    const Vector3D p = ray.at(t) - mQ;
 
     // Local frame canonical barycentric coordinate test.
     const f64 uu = mU.dot(mU);
@@ -47,12 +78,19 @@ Option<SurfaceInteraction> QuadPrim::intersect(
     if (!Interval::unit.contains(alpha) || !Interval::unit.contains(beta))
         return std::nullopt;
 
-    if (ray.direction.dot(mNormal) > 0.0)
-        return SurfaceInteraction(
-            P, -mNormal, SurfaceInteraction::Face::Inside, t
-        );
-    else
-        return SurfaceInteraction(
-            P, mNormal, SurfaceInteraction::Face::Outside, t
-        );
+    return t;
+}
+
+void QuadPrim::saveShape(BinaryWriter& writer) const {
+    writer.write(Shape::Quad);
+    writer.writeXYZ(mQ);
+    writer.writeXYZ(mU);
+    writer.writeXYZ(mV);
+}
+
+std::shared_ptr<QuadPrim> QuadPrim::loadShape(BinaryReader& reader) {
+    const Point3D Q = reader.readXYZ<Point3D>();
+    const Vector3D u = reader.readXYZ<Vector3D>();
+    const Vector3D v = reader.readXYZ<Vector3D>();
+    return std::make_shared<QuadPrim>(Q, u, v);
 }
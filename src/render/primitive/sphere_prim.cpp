@@ -56,3 +56,45 @@ Option<SurfaceInteraction> SpherePrim::intersect(
             p, normal, SurfaceInteraction::Face::Outside, t
         );
 }
+
+bool SpherePrim::occluded(const Ray& ray, const Interval& bounds) const {
+    // Set up quadratic.
+    const Vector3D oc = ray.origin - mCenter;
+    const f64 a = ray.direction.dot();
+    const f64 b = 2.0 * ray.direction.dot(oc);
+    const f64 c = oc.dot() - math::sqr(mRadius);
+
+    // Solve quadratic.
+    std::pair<Option<f64>, Option<f64>> roots = math::quadratic_roots(a, b, c);
+
+    // Occluded if either root lies within the bounds.
+    return (roots.first && bounds.contains(*roots.first)) ||
+           (roots.second && bounds.contains(*roots.second));
+}
+
+f64 SpherePrim::area() const {
+    return 4.0 * math::pi<f64>() * math::sqr(mRadius);
+}
+
+Option<SurfaceSample> SpherePrim::sample(const f64 u1, const f64 u2) const {
+    // Uniformly sample a direction on the unit sphere.
+    const f64 z = 1.0 - 2.0 * u1;
+    const f64 r = std::sqrt(std::max(0.0, 1.0 - z * z));
+    const f64 phi = 2.0 * math::pi<f64>() * u2;
+
+    const Normal3D normal(r * std::cos(phi), r * std::sin(phi), z);
+
+    return SurfaceSample{mCenter + mRadius * Vector3D(normal), normal};
+}
+
+void SpherePrim::saveShape(BinaryWriter& writer) const {
+    writer.write(Shape::Sphere);
+    writer.writeXYZ(mCenter);
+    writer.write(mRadius);
+}
+
+std::shared_ptr<SpherePrim> SpherePrim::loadShape(BinaryReader& reader) {
+    const Point3D center = reader.readXYZ<Point3D>();
+    const f64 radius = reader.read<f64>();
+    return std::make_shared<SpherePrim>(center, radius);
+}
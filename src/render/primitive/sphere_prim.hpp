@@ -15,6 +15,22 @@ public:
         const Ray& ray, const Interval& bounds
     ) const override;
 
+    /// @brief Determines whether the ray hits the sphere within the parameter
+    /// bounds.
+    bool occluded(const Ray& ray, const Interval& bounds) const override;
+
+    /// @brief Computes the object space surface area of the sphere.
+    f64 area() const override;
+
+    /// @brief Samples a point uniformly by area on the sphere.
+    Option<SurfaceSample> sample(const f64 u1, const f64 u2) const override;
+
+    /// @brief Writes the shape and parameters of the sphere.
+    void saveShape(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by saveShape() after the shape.
+    static std::shared_ptr<SpherePrim> loadShape(BinaryReader& reader);
+
 private:
     Point3D mCenter;
     f64 mRadius;
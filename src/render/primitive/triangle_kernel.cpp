@@ -0,0 +1,227 @@
+#include "triangle_kernel.hpp"
+
+#include <utility>
+
+#include "common/math/numeric.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TRIANGLE_KERNEL_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/// @brief Chooses the fastest block kernel the CPU supports.
+BlockKernel detectBlockKernel() {
+#ifdef TRIANGLE_KERNEL_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return BlockKernel::Avx2;
+#endif
+    return BlockKernel::Scalar;
+}
+
+const BlockKernel cBlockKernel = detectBlockKernel();
+
+}
+
+Normal3D TriangleRecord::normal() const {
+    return Normal3D((b - a).cross(c - a)).normalize();
+}
+
+TriangleBlock::TriangleBlock() : a(), b(), c() {
+}
+
+void TriangleBlock::set(const Index lane, const TriangleRecord& tri) {
+    for (Index axis = 0; axis < 3; ++axis) {
+        a[axis][lane] = tri.a[axis];
+        b[axis][lane] = tri.b[axis];
+        c[axis][lane] = tri.c[axis];
+    }
+}
+
+TriangleRay::TriangleRay(const Ray& ray) : mOrigin(ray.origin) {
+    const Vector3D& d = ray.direction;
+
+    mKz = 0;
+    if (math::abs(d.y) > math::abs(d[mKz]))
+        mKz = 1;
+    if (math::abs(d.z) > math::abs(d[mKz]))
+        mKz = 2;
+    mKx = (mKz + 1) % 3;
+    mKy = (mKx + 1) % 3;
+
+    // Swap the other axes to preserve the winding of the triangles.
+    if (d[mKz] < 0.0)
+        std::swap(mKx, mKy);
+
+    mSx = d[mKx] / d[mKz];
+    mSy = d[mKy] / d[mKz];
+    mSz = 1.0 / d[mKz];
+}
+
+Option<BlockHit> TriangleRay::intersect(
+    const TriangleBlock& block, const Interval& bounds
+) const {
+    return intersect(block, bounds, cBlockKernel);
+}
+
+Option<BlockHit> TriangleRay::intersect(
+    const TriangleBlock& block,
+    const Interval& bounds,
+    const BlockKernel kernel
+) const {
+    assertm(supports(kernel), "block kernel not supported");
+
+#ifdef TRIANGLE_KERNEL_AVX2
+    if (kernel == BlockKernel::Avx2)
+        return intersectAvx2(block, bounds);
+#endif
+    return intersectScalar(block, bounds);
+}
+
+bool TriangleRay::supports(const BlockKernel kernel) {
+    switch (kernel) {
+    case BlockKernel::Scalar:
+        return true;
+    case BlockKernel::Avx2:
+#ifdef TRIANGLE_KERNEL_AVX2
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    unreachable;
+}
+
+BlockKernel TriangleRay::blockKernel() {
+    return cBlockKernel;
+}
+
+Option<BlockHit> TriangleRay::intersectScalar(
+    const TriangleBlock& block, const Interval& bounds
+) const {
+    Option<BlockHit> closest = std::nullopt;
+    Interval search = bounds;
+
+    for (Index lane = 0; lane < TriangleBlock::WIDTH; ++lane) {
+        const TriangleRecord tri{
+            Point3D(block.a[0][lane], block.a[1][lane], block.a[2][lane]),
+            Point3D(block.b[0][lane], block.b[1][lane], block.b[2][lane]),
+            Point3D(block.c[0][lane], block.c[1][lane], block.c[2][lane]),
+        };
+
+        if (const Option<f64> t = intersect(tri, search)) {
+            search.max = *t;
+            closest = BlockHit{*t, lane};
+        }
+    }
+
+    return closest;
+}
+
+#ifdef TRIANGLE_KERNEL_AVX2
+
+// Mirrors the record test operation for operation, so that every lane
+// computes bit-identical values. FMA is deliberately not enabled, as fused
+// products would round differently.
+__attribute__((target("avx2"))) Option<BlockHit> TriangleRay::intersectAvx2(
+    const TriangleBlock& block, const Interval& bounds
+) const {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d ox = _mm256_set1_pd(mOrigin[mKx]);
+    const __m256d oy = _mm256_set1_pd(mOrigin[mKy]);
+    const __m256d oz = _mm256_set1_pd(mOrigin[mKz]);
+    const __m256d sx = _mm256_set1_pd(mSx);
+    const __m256d sy = _mm256_set1_pd(mSy);
+    const __m256d sz = _mm256_set1_pd(mSz);
+
+    // Vertices relative to the ray origin.
+    const __m256d a_z = _mm256_sub_pd(_mm256_load_pd(block.a[mKz]), oz);
+    const __m256d b_z = _mm256_sub_pd(_mm256_load_pd(block.b[mKz]), oz);
+    const __m256d c_z = _mm256_sub_pd(_mm256_load_pd(block.c[mKz]), oz);
+
+    // Shear the vertices in the plane perpendicular to the ray.
+    const __m256d ax = _mm256_sub_pd(
+        _mm256_sub_pd(_mm256_load_pd(block.a[mKx]), ox), _mm256_mul_pd(sx, a_z)
+    );
+    const __m256d ay = _mm256_sub_pd(
+        _mm256_sub_pd(_mm256_load_pd(block.a[mKy]), oy), _mm256_mul_pd(sy, a_z)
+    );
+    const __m256d bx = _mm256_sub_pd(
+        _mm256_sub_pd(_mm256_load_pd(block.b[mKx]), ox), _mm256_mul_pd(sx, b_z)
+    );
+    const __m256d by = _mm256_sub_pd(
+        _mm256_sub_pd(_mm256_load_pd(block.b[mKy]), oy), _mm256_mul_pd(sy, b_z)
+    );
+    const __m256d cx = _mm256_sub_pd(
+        _mm256_sub_pd(_mm256_load_pd(block.c[mKx]), ox), _mm256_mul_pd(sx, c_z)
+    );
+    const __m256d cy = _mm256_sub_pd(
+        _mm256_sub_pd(_mm256_load_pd(block.c[mKy]), oy), _mm256_mul_pd(sy, c_z)
+    );
+
+    // Scaled barycentric coordinates from the edge functions.
+    const __m256d u =
+        _mm256_sub_pd(_mm256_mul_pd(cx, by), _mm256_mul_pd(cy, bx));
+    const __m256d v =
+        _mm256_sub_pd(_mm256_mul_pd(ax, cy), _mm256_mul_pd(ay, cx));
+    const __m256d w =
+        _mm256_sub_pd(_mm256_mul_pd(bx, ay), _mm256_mul_pd(by, ax));
+
+    const __m256d negative = _mm256_or_pd(
+        _mm256_or_pd(
+            _mm256_cmp_pd(u, zero, _CMP_LT_OQ),
+            _mm256_cmp_pd(v, zero, _CMP_LT_OQ)
+        ),
+        _mm256_cmp_pd(w, zero, _CMP_LT_OQ)
+    );
+    const __m256d positive = _mm256_or_pd(
+        _mm256_or_pd(
+            _mm256_cmp_pd(u, zero, _CMP_GT_OQ),
+            _mm256_cmp_pd(v, zero, _CMP_GT_OQ)
+        ),
+        _mm256_cmp_pd(w, zero, _CMP_GT_OQ)
+    );
+
+    const __m256d det = _mm256_add_pd(_mm256_add_pd(u, v), w);
+    const __m256d t = _mm256_div_pd(
+        _mm256_mul_pd(
+            _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(u, a_z), _mm256_mul_pd(v, b_z)),
+                _mm256_mul_pd(w, c_z)
+            ),
+            sz
+        ),
+        det
+    );
+
+    // Lanes inside the triangle, off its plane and within the bounds.
+    __m256d valid = _mm256_andnot_pd(
+        _mm256_and_pd(negative, positive), _mm256_cmp_pd(det, zero, _CMP_NEQ_UQ)
+    );
+    valid = _mm256_and_pd(
+        valid, _mm256_cmp_pd(t, _mm256_set1_pd(bounds.min), _CMP_GE_OQ)
+    );
+    valid = _mm256_and_pd(
+        valid, _mm256_cmp_pd(t, _mm256_set1_pd(bounds.max), _CMP_LE_OQ)
+    );
+
+    const int mask = _mm256_movemask_pd(valid);
+    if (mask == 0)
+        return std::nullopt;
+
+    alignas(32) f64 ts[TriangleBlock::WIDTH];
+    _mm256_store_pd(ts, t);
+
+    // Ties go to the later lane, as in the scalar test.
+    Option<BlockHit> closest = std::nullopt;
+    for (Index lane = 0; lane < TriangleBlock::WIDTH; ++lane) {
+        if ((mask & (1 << lane)) && (!closest || ts[lane] <= closest->t))
+            closest = BlockHit{ts[lane], lane};
+    }
+
+    return closest;
+}
+
+#endif
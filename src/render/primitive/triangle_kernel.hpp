@@ -0,0 +1,147 @@
+#pragma once
+
+#include "common/math/interval.hpp"
+#include "common/math/normal.hpp"
+#include "common/math/point.hpp"
+#include "common/math/ray.hpp"
+#include "common/prelude.hpp"
+
+/// @brief Triangle stored by its vertex positions, laid out for the
+/// watertight intersection kernel.
+struct TriangleRecord {
+    Point3D a;
+    Point3D b;
+    Point3D c;
+
+    /// @brief Computes the unit geometric normal, (b - a) x (c - a).
+    Normal3D normal() const;
+};
+
+/// @brief Block of triangles in structure-of-arrays layout, so that one ray
+/// is tested against all of them with vector instructions. Unused lanes hold
+/// degenerate triangles, which are never hit.
+struct alignas(32) TriangleBlock {
+    /// @brief Number of triangles in a block.
+    static constexpr Size WIDTH = 4;
+
+    // Vertex coordinates by axis and lane.
+    f64 a[3][WIDTH];
+    f64 b[3][WIDTH];
+    f64 c[3][WIDTH];
+
+    /// @brief Constructs the block with every lane unused.
+    TriangleBlock();
+
+    /// @brief Stores the triangle in the lane.
+    void set(const Index lane, const TriangleRecord& tri);
+};
+
+/// @brief Closest hit within a triangle block.
+struct BlockHit {
+    f64 t;
+    Index lane;
+};
+
+/// @brief Implementation of the triangle block test.
+enum class BlockKernel {
+    Scalar = 0,
+    Avx2,
+};
+
+/// @brief Ray prepared for watertight ray-triangle intersection (Woop,
+/// Benthin and Wald, 2013). The ray is permuted so that its largest direction
+/// component is z and sheared so that it points along +z. Triangles are
+/// moved into that space and tested with 2D edge functions, which are
+/// evaluated identically for the shared edge of neighbouring triangles, so
+/// rays cannot slip between them. Preparing the ray once amortizes the
+/// divisions over every triangle it is tested against.
+class TriangleRay {
+public:
+    explicit TriangleRay(const Ray& ray);
+    ~TriangleRay() = default;
+
+    /// @brief Computes the ray parameter of the hit with the triangle within
+    /// the parameter bounds, if any. Both faces are hit, and degenerate
+    /// triangles are never hit.
+    Option<f64> intersect(
+        const TriangleRecord& tri, const Interval& bounds
+    ) const;
+
+    /// @brief Computes the closest hit with the triangles of the block within
+    /// the parameter bounds, if any, with the fastest kernel the CPU
+    /// supports. Every kernel returns the same hits as the record test.
+    Option<BlockHit> intersect(
+        const TriangleBlock& block, const Interval& bounds
+    ) const;
+
+    /// @brief Computes the closest hit with the triangles of the block with
+    /// the given kernel, which must be supported.
+    Option<BlockHit> intersect(
+        const TriangleBlock& block,
+        const Interval& bounds,
+        const BlockKernel kernel
+    ) const;
+
+    /// @brief Determines whether the kernel is built in and supported by the
+    /// CPU.
+    static bool supports(const BlockKernel kernel);
+
+    /// @brief Retrieves the kernel used by intersect(), which is chosen once
+    /// at startup.
+    static BlockKernel blockKernel();
+
+private:
+    /// @brief Tests the block one lane at a time.
+    Option<BlockHit> intersectScalar(
+        const TriangleBlock& block, const Interval& bounds
+    ) const;
+
+    /// @brief Tests all lanes of the block at once with AVX2.
+    Option<BlockHit> intersectAvx2(
+        const TriangleBlock& block, const Interval& bounds
+    ) const;
+
+    Point3D mOrigin;
+
+    // Permuted axes, with the largest direction component on mKz.
+    Index mKx, mKy, mKz;
+
+    // Shear constants.
+    f64 mSx, mSy, mSz;
+};
+
+inline Option<f64> TriangleRay::intersect(
+    const TriangleRecord& tri, const Interval& bounds
+) const {
+    const Vector3D A = tri.a - mOrigin;
+    const Vector3D B = tri.b - mOrigin;
+    const Vector3D C = tri.c - mOrigin;
+
+    // Shear the vertices in the plane perpendicular to the ray.
+    const f64 ax = A[mKx] - mSx * A[mKz];
+    const f64 ay = A[mKy] - mSy * A[mKz];
+    const f64 bx = B[mKx] - mSx * B[mKz];
+    const f64 by = B[mKy] - mSy * B[mKz];
+    const f64 cx = C[mKx] - mSx * C[mKz];
+    const f64 cy = C[mKy] - mSy * C[mKz];
+
+    // Scaled barycentric coordinates from the edge functions. The ray passes
+    // through the triangle if they all have the same sign.
+    const f64 u = cx * by - cy * bx;
+    const f64 v = ax * cy - ay * cx;
+    const f64 w = bx * ay - by * ax;
+
+    if ((u < 0.0 || v < 0.0 || w < 0.0) && (u > 0.0 || v > 0.0 || w > 0.0))
+        return std::nullopt;
+
+    // No hit if the ray lies in the plane of the triangle.
+    const f64 det = u + v + w;
+    if (det == 0.0)
+        return std::nullopt;
+
+    const f64 t = (u * A[mKz] + v * B[mKz] + w * C[mKz]) * mSz / det;
+    if (!bounds.contains(t))
+        return std::nullopt;
+
+    return t;
+}
@@ -1,16 +1,12 @@
 #include "triangle_prim.hpp"
 
-#include "common/math/almost.hpp"
-
 TrianglePrim::TrianglePrim(
     const Point3D& Q, const Vector3D& u, const Vector3D& v
 )
-    : mQ(Q), mU(u), mV(v) {
+    : mQ(Q), mU(u), mV(v), mRecord{Q, Q + u, Q + v} {
     mKind = Kind::Implicit;
 
     mNormal = Normal3D(mU.cross(mV)).normalize();
-    mD = mNormal.dot(mQ.pos());
-    mW = Vector3D(mNormal) / mNormal.dot();
 
     const AABB bbox1 = AABB(mQ, mQ + mU);
     const AABB bbox2 = AABB(mQ, mQ + mV);
@@ -20,35 +16,12 @@ TrianglePrim::TrianglePrim(
 Option<SurfaceInteraction> TrianglePrim::intersect(
     const Ray& ray, const Interval& bounds
 ) const {
-    const f64 denom = mNormal.dot(ray.direction);
-
-    // No hit if the ray is parallel to the plane.
-    if (almost::le_zero(math::abs(denom)))
-        return std::nullopt;
-
-    // No hit if the ray parameter is outside the parameter bounds.
-    const f64 t = (mD - mNormal.dot(ray.origin.pos())) / denom;
-    if (!bounds.contains(t))
+    const Option<f64> hit = TriangleRay(ray).intersect(mRecord, bounds);
+    if (!hit)
         return std::nullopt;
 
+    const f64 t = *hit;
     const Point3D P = ray.at(t);
-    const Vector3D p = P - mQ;
-
-    // Local frame canonical barycentric coordinate test.
-    const f64 uu = mU.dot(mU);
-    const f64 uv = mU.dot(mV);
-    const f64 vv = mV.dot(mV);
-    const f64 pu = p.dot(mU);
-    const f64 pv = p.dot(mV);
-
-    const f64 denom_bary = uv * uv - uu * vv;
-    const f64 alpha = (uv * pv - vv * pu) / denom_bary;
-    const f64 beta = (uv * pu - uu * pv) / denom_bary;
-
-    // No hit if the ray is outside the plane boundaries.
-    if (almost::l_zero(alpha) || almost::l_zero(beta) ||
-        almost::g(alpha + beta, 1.0))
-        return std::nullopt;
 
     if (ray.direction.dot(mNormal) > 0.0)
         return SurfaceInteraction(
@@ -59,3 +32,37 @@ Option<SurfaceInteraction> TrianglePrim::intersect(
             P, mNormal, SurfaceInteraction::Face::Outside, t
         );
 }
+
+bool TrianglePrim::occluded(const Ray& ray, const Interval& bounds) const {
+    return TriangleRay(ray).intersect(mRecord, bounds).has_value();
+}
+
+f64 TrianglePrim::area() const {
+    return 0.5 * mU.cross(mV).length();
+}
+
+Option<SurfaceSample> TrianglePrim::sample(const f64 u1, const f64 u2) const {
+    // Fold samples outside the triangle back into it.
+    f64 alpha = u1;
+    f64 beta = u2;
+    if (alpha + beta > 1.0) {
+        alpha = 1.0 - alpha;
+        beta = 1.0 - beta;
+    }
+
+    return SurfaceSample{mQ + alpha * mU + beta * mV, mNormal};
+}
+
+void TrianglePrim::saveShape(BinaryWriter& writer) const {
+    writer.write(Shape::Triangle);
+    writer.writeXYZ(mQ);
+    writer.writeXYZ(mU);
+    writer.writeXYZ(mV);
+}
+
+std::shared_ptr<TrianglePrim> TrianglePrim::loadShape(BinaryReader& reader) {
+    const Point3D Q = reader.readXYZ<Point3D>();
+    const Vector3D u = reader.readXYZ<Vector3D>();
+    const Vector3D v = reader.readXYZ<Vector3D>();
+    return std::make_shared<TrianglePrim>(Q, u, v);
+}
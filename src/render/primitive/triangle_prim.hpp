@@ -3,24 +3,40 @@
 #include "common/math/point.hpp"
 #include "common/math/vector.hpp"
 #include "primitive.hpp"
+#include "triangle_kernel.hpp"
 
-/// @brief Triangle primitive.
+/// @brief Triangle primitive. Intersections use the watertight triangle
+/// kernel.
 class TrianglePrim : public Primitive {
 public:
     TrianglePrim(const Point3D& Q, const Vector3D& u, const Vector3D& v);
     ~TrianglePrim() override = default;
 
-    /// @brief Computes the surface intersection with a triangle represented by
-    /// barycentric coordinates.
+    /// @brief Computes the surface intersection with the triangle.
     Option<SurfaceInteraction> intersect(
         const Ray& ray, const Interval& bounds
     ) const override;
 
+    /// @brief Determines whether the ray hits the triangle within the parameter
+    /// bounds.
+    bool occluded(const Ray& ray, const Interval& bounds) const override;
+
+    /// @brief Computes the object space surface area of the triangle.
+    f64 area() const override;
+
+    /// @brief Samples a point uniformly by area on the triangle.
+    Option<SurfaceSample> sample(const f64 u1, const f64 u2) const override;
+
+    /// @brief Writes the shape and parameters of the triangle.
+    void saveShape(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by saveShape() after the shape.
+    static std::shared_ptr<TrianglePrim> loadShape(BinaryReader& reader);
+
 private:
     Point3D mQ;
     Vector3D mU, mV;
 
     Normal3D mNormal;
-    Vector3D mW;
-    f64 mD;
+    TriangleRecord mRecord;
 };
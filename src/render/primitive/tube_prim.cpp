@@ -1,5 +1,7 @@
 #include "tube_prim.hpp"
 
+#include <algorithm>
+
 #include "common/math/rootfinding.hpp"
 
 TubePrim::TubePrim(
@@ -128,3 +130,119 @@ Option<SurfaceInteraction> TubePrim::intersect(
 
     return closest;
 }
+
+bool TubePrim::occluded(const Ray& ray, const Interval& bounds) const {
+    // Tube side.
+    {
+        // Convenience component variables.
+        const f64 ox = ray.origin.x - mCenter.x;
+        const f64 oy = ray.origin.y - mCenter.y;
+
+        const f64 dx = ray.direction.x;
+        const f64 dy = ray.direction.y;
+
+        // Set up quadratic.
+        const f64 a = dx * dx + dy * dy;
+        const f64 b = 2.0 * (dx * ox + dy * oy);
+        const f64 c = ox * ox + oy * oy - mRadius * mRadius;
+
+        // Solve quadratic.
+        std::pair<Option<f64>, Option<f64>> roots =
+            math::quadratic_roots(a, b, c);
+
+        const Interval height(-mHeight / 2.0, mHeight / 2.0);
+
+        for (const Option<f64>& root : {roots.first, roots.second}) {
+            if (root && bounds.contains(*root) &&
+                height.contains(ray.at(*root).z))
+                return true;
+        }
+    }
+
+    // Caps.
+    if (ray.direction.z != 0.0) {
+        auto cap_hit = [&](const f64 z) {
+            const f64 t = (z - ray.origin.z) / ray.direction.z;
+            if (!bounds.contains(t))
+                return false;
+
+            const Point3D p = ray.at(t);
+            const f64 dist2 = (p.x - mCenter.x) * (p.x - mCenter.x) +
+                              (p.y - mCenter.y) * (p.y - mCenter.y);
+            return dist2 <= mRadius * mRadius;
+        };
+
+        if (mTopCap && cap_hit(mCenter.z + mHeight / 2.0))
+            return true;
+        if (mBottomCap && cap_hit(mCenter.z - mHeight / 2.0))
+            return true;
+    }
+
+    return false;
+}
+
+f64 TubePrim::area() const {
+    const f64 cap = math::pi<f64>() * math::sqr(mRadius);
+
+    f64 total = 2.0 * math::pi<f64>() * mRadius * mHeight;
+    if (mTopCap)
+        total += cap;
+    if (mBottomCap)
+        total += cap;
+
+    return total;
+}
+
+Option<SurfaceSample> TubePrim::sample(const f64 u1, const f64 u2) const {
+    const f64 side = 2.0 * math::pi<f64>() * mRadius * mHeight;
+    const f64 cap = math::pi<f64>() * math::sqr(mRadius);
+
+    // Select the side or a cap proportionally to its area, then rescale u1 so
+    // it can be reused to sample the chosen part.
+    f64 target = u1 * area();
+
+    if (target < side) {
+        const f64 z = mCenter.z + (target / side - 0.5) * mHeight;
+        const f64 phi = 2.0 * math::pi<f64>() * u2;
+
+        const Normal3D normal(std::cos(phi), std::sin(phi), 0.0);
+        const Point3D p(
+            mCenter.x + mRadius * normal.x, mCenter.y + mRadius * normal.y, z
+        );
+
+        return SurfaceSample{p, normal};
+    }
+    target -= side;
+
+    const bool top = mTopCap && (!mBottomCap || target < cap);
+    const f64 u = std::clamp((top ? target : target - cap) / cap, 0.0, 1.0);
+
+    // Uniformly sample the cap disk.
+    const f64 r = mRadius * std::sqrt(u);
+    const f64 phi = 2.0 * math::pi<f64>() * u2;
+
+    const f64 z = top ? mCenter.z + mHeight / 2.0 : mCenter.z - mHeight / 2.0;
+    const Point3D p(
+        mCenter.x + r * std::cos(phi), mCenter.y + r * std::sin(phi), z
+    );
+
+    return SurfaceSample{p, Normal3D(0.0, 0.0, top ? 1.0 : -1.0)};
+}
+
+void TubePrim::saveShape(BinaryWriter& writer) const {
+    writer.write(Shape::Tube);
+    writer.writeXYZ(mCenter);
+    writer.write(mRadius);
+    writer.write(mHeight);
+    writer.write<u8>(mTopCap);
+    writer.write<u8>(mBottomCap);
+}
+
+std::shared_ptr<TubePrim> TubePrim::loadShape(BinaryReader& reader) {
+    const Point3D center = reader.readXYZ<Point3D>();
+    const f64 radius = reader.read<f64>();
+    const f64 height = reader.read<f64>();
+    const bool top = reader.read<u8>() != 0;
+    const bool bottom = reader.read<u8>() != 0;
+    return std::make_shared<TubePrim>(center, radius, height, top, bottom);
+}
@@ -20,6 +20,24 @@ public:
         const Ray& ray, const Interval& bounds
     ) const override;
 
+    /// @brief Determines whether the ray hits the tube within the parameter
+    /// bounds.
+    bool occluded(const Ray& ray, const Interval& bounds) const override;
+
+    /// @brief Computes the object space surface area of the tube side and
+    /// enabled caps.
+    f64 area() const override;
+
+    /// @brief Samples a point uniformly by area on the tube side and enabled
+    /// caps.
+    Option<SurfaceSample> sample(const f64 u1, const f64 u2) const override;
+
+    /// @brief Writes the shape and parameters of the tube.
+    void saveShape(BinaryWriter& writer) const override;
+
+    /// @brief Reads the parameters written by saveShape() after the shape.
+    static std::shared_ptr<TubePrim> loadShape(BinaryReader& reader);
+
 private:
     Point3D mCenter;
     f64 mRadius, mHeight;
@@ -0,0 +1,26 @@
+#include "independent_sampler.hpp"
+
+IndependentSampler::IndependentSampler(
+    const Size samples_per_pixel, const u64 seed
+)
+    : Sampler(samples_per_pixel, seed), mRng() {
+}
+
+void IndependentSampler::startPixelSample(
+    const Index pixel, const Index sample
+) {
+    Sampler::startPixelSample(pixel, sample);
+
+    // Successive draws are the successive dimensions of the sample.
+    mRng.reseed(pcg::mix(mSeed ^ pcg::mix(pixel)), sample);
+}
+
+f64 IndependentSampler::sample1D(const Index dimension) {
+    return mRng.uniform<f64>();
+}
+
+Vector2D IndependentSampler::sample2D(const Index dimension) {
+    const f64 x = mRng.uniform<f64>();
+    const f64 y = mRng.uniform<f64>();
+    return Vector2D(x, y);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "common/util/pcg.hpp"
+#include "sampler.hpp"
+
+/// @brief Sampler that draws every dimension independently and uniformly.
+class IndependentSampler : public Sampler {
+public:
+    IndependentSampler(const Size samples_per_pixel, const u64 seed);
+    ~IndependentSampler() override = default;
+
+    void startPixelSample(const Index pixel, const Index sample) override;
+
+protected:
+    f64 sample1D(const Index dimension) override;
+
+    Vector2D sample2D(const Index dimension) override;
+
+private:
+    PCG32 mRng;
+};
@@ -0,0 +1,171 @@
+#include "pmj02_sampler.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "common/util/pcg.hpp"
+#include "sampling.hpp"
+
+namespace {
+
+/// @brief Occupancy of the elementary intervals of a point set at one level.
+/// At level k there are k + 1 grids. Grid j has 2^j columns and 2^(k - j)
+/// rows, so each of its 2^k cells has area 2^-k.
+class ElementaryIntervals {
+public:
+    ElementaryIntervals(
+        const u32 level, const std::vector<PMJ02Sampler::Point>& points
+    )
+        : mLevel(level), mOccupied((level + 1) << level, false) {
+        for (const PMJ02Sampler::Point& point : points)
+            occupy(point[0] >> (32 - mLevel), point[1] >> (32 - mLevel));
+    }
+
+    /// @brief Marks the cells containing the finest cell (a, b) as occupied.
+    void occupy(const u32 a, const u32 b) {
+        for (u32 j = 0; j <= mLevel; ++j)
+            mOccupied[cell(j, a >> (mLevel - j), b >> j)] = true;
+    }
+
+    /// @brief Determines whether cell (x, y) of grid j is occupied.
+    bool occupied(const u32 j, const u32 x, const u32 y) const {
+        return mOccupied[cell(j, x, y)];
+    }
+
+    /// @brief Finds a random finest cell (a, b) whose cells are unoccupied in
+    /// every grid.
+    /// @returns Whether such a cell exists.
+    bool find(PCG32& rng, u32& a, u32& b) const {
+        // Visit the free rows in a random order, and search the column bits
+        // from the most significant down, pruning occupied cells.
+        std::vector<u32> rows;
+        for (u32 y = 0; y < (1u << mLevel); ++y) {
+            if (!occupied(0, 0, y))
+                rows.push_back(y);
+        }
+
+        for (Index i = rows.size(); i > 1; --i)
+            std::swap(rows[i - 1], rows[rng.next() % i]);
+
+        for (const u32 y : rows) {
+            if (search(rng, y, 0, 0, a)) {
+                b = y;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    Index cell(const u32 j, const u32 x, const u32 y) const {
+        return (static_cast<Index>(j) << mLevel) + x + (y << j);
+    }
+
+    /// @brief Extends the top `j` bits `x` of the column in row `y`.
+    bool search(
+        PCG32& rng, const u32 y, const u32 j, const u32 x, u32& a
+    ) const {
+        if (j == mLevel) {
+            a = x;
+            return true;
+        }
+
+        const u32 first = rng.next() & 1;
+        for (u32 bit = 0; bit < 2; ++bit) {
+            const u32 next = (x << 1) | (first ^ bit);
+            if (!occupied(j + 1, next, y >> (j + 1)) &&
+                search(rng, y, j + 1, next, a))
+                return true;
+        }
+
+        return false;
+    }
+
+    u32 mLevel;
+    std::vector<bool> mOccupied;
+};
+
+}
+
+PMJ02Sampler::PMJ02Sampler(const Size samples_per_pixel, const u64 seed)
+    : Sampler(samples_per_pixel, seed) {
+}
+
+std::vector<PMJ02Sampler::Point> PMJ02Sampler::generate(
+    const Size count, const u64 seed
+) {
+    assertm(std::has_single_bit(count), "count must be a power of two");
+
+    PCG32 rng(seed, 0);
+
+    std::vector<Point> points;
+    points.reserve(count);
+    points.push_back(Point{rng.next(), rng.next()});
+
+    for (u32 level = 1; points.size() < count; ++level) {
+        // Fill the next power of two so that every elementary interval of
+        // area 2^-level holds exactly one point.
+        ElementaryIntervals intervals(level, points);
+
+        const Size target = Size(1) << level;
+        while (points.size() < target) {
+            u32 a = 0;
+            u32 b = 0;
+            const bool found = intervals.find(rng, a, b);
+            assertm(found, "a (0,2) sequence can always be extended");
+
+            intervals.occupy(a, b);
+
+            // Jitter uniformly within the finest cell.
+            const u32 x = (a << (32 - level)) | (rng.next() >> level);
+            const u32 y = (b << (32 - level)) | (rng.next() >> level);
+            points.push_back(Point{x, y});
+        }
+    }
+
+    return points;
+}
+
+f64 PMJ02Sampler::sample1D(const Index dimension) {
+    const u64 key = sampling::hash(mSeed, mPixel, dimension);
+    const u32 count = static_cast<u32>(std::max<Size>(mSamplesPerPixel, 1));
+
+    const u32 stratum =
+        sampling::permute(mSample % count, count, static_cast<u32>(key));
+
+    PCG32 rng(key, mSample);
+    const f64 jitter = rng.uniform<f64>();
+
+    return std::min((stratum + jitter) / count, sampling::cOneMinusEpsilon);
+}
+
+Vector2D PMJ02Sampler::sample2D(const Index dimension) {
+    const u64 key = sampling::hash(mSeed, mPixel, dimension);
+
+    // Reuse the sequences with a fresh shift once a pixel takes more samples
+    // than a sequence holds.
+    const Index pass = mSample / SET_SIZE;
+    const u64 shift = sampling::hash(key, pass);
+
+    const Point& point = sets()[key % SET_COUNT][mSample % SET_SIZE];
+
+    // XOR with a random binary fraction maps elementary intervals onto
+    // elementary intervals, so the shifted points keep the stratification.
+    const u32 x = point[0] ^ static_cast<u32>(shift);
+    const u32 y = point[1] ^ static_cast<u32>(shift >> 32);
+
+    return Vector2D(sampling::toUnit(x), sampling::toUnit(y));
+}
+
+const std::vector<std::vector<PMJ02Sampler::Point>>& PMJ02Sampler::sets() {
+    static const std::vector<std::vector<Point>> sets = [] {
+        std::vector<std::vector<Point>> sets;
+        sets.reserve(SET_COUNT);
+        for (Index i = 0; i < SET_COUNT; ++i)
+            sets.push_back(generate(SET_SIZE, i));
+        return sets;
+    }();
+
+    return sets;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "sampler.hpp"
+
+/// @brief Progressive multi-jittered (0,2) sampler. 2D dimensions are drawn
+/// from precomputed sequences in which every power of two prefix has exactly
+/// one point in every elementary interval of its size. Each pixel and
+/// dimension selects one sequence and applies a random digital shift, which
+/// keeps the stratification. 1D dimensions are jittered and stratified.
+class PMJ02Sampler : public Sampler {
+public:
+    PMJ02Sampler(const Size samples_per_pixel, const u64 seed);
+    ~PMJ02Sampler() override = default;
+
+    /// @brief Number of precomputed sequences.
+    static constexpr Size SET_COUNT = 8;
+
+    /// @brief Number of points in each precomputed sequence. Must be a power
+    /// of two.
+    static constexpr Size SET_SIZE = 4096;
+
+    /// @brief A point of a sequence as a pair of 32-bit fixed point
+    /// fractions.
+    using Point = std::array<u32, 2>;
+
+    /// @brief Generates a progressive (0,2) sequence of `count` points,
+    /// where `count` is a power of two.
+    static std::vector<Point> generate(const Size count, const u64 seed);
+
+protected:
+    f64 sample1D(const Index dimension) override;
+
+    Vector2D sample2D(const Index dimension) override;
+
+private:
+    /// @brief Retrieves the precomputed sequences. Generated on first use.
+    static const std::vector<std::vector<Point>>& sets();
+};
@@ -0,0 +1,29 @@
+#include "sampler.hpp"
+
+Sampler::Sampler(const Size samples_per_pixel, const u64 seed)
+    : mSamplesPerPixel(samples_per_pixel),
+      mSeed(seed),
+      mPixel(0),
+      mSample(0),
+      mDimension(0) {
+}
+
+void Sampler::startPixelSample(const Index pixel, const Index sample) {
+    mPixel = pixel;
+    mSample = sample;
+    mDimension = 0;
+}
+
+f64 Sampler::get1D() {
+    return sample1D(mDimension++);
+}
+
+Vector2D Sampler::get2D() {
+    const Vector2D u = sample2D(mDimension);
+    mDimension += 2;
+    return u;
+}
+
+Size Sampler::samplesPerPixel() const {
+    return mSamplesPerPixel;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+
+#include "common/math/vector.hpp"
+#include "common/prelude.hpp"
+
+/// @brief Sampler base class. Provides the random numbers consumed by one
+/// sample of one pixel. Each call to `get1D` or `get2D` consumes the next
+/// dimension, so the values only depend on the seed, the pixel, the sample
+/// index, and the order in which they are requested.
+class Sampler {
+public:
+    Sampler(const Size samples_per_pixel, const u64 seed);
+    virtual ~Sampler() = default;
+
+    /// @brief Starts sample `sample` of pixel `pixel` and resets the
+    /// dimension to zero.
+    virtual void startPixelSample(const Index pixel, const Index sample);
+
+    /// @brief Generates the next 1D sample in [0, 1).
+    f64 get1D();
+
+    /// @brief Generates the next 2D sample in [0, 1)^2.
+    Vector2D get2D();
+
+    /// @brief Retrieves the number of samples taken per pixel.
+    Size samplesPerPixel() const;
+
+protected:
+    /// @brief Generates the 1D sample for the given dimension of the current
+    /// pixel sample.
+    virtual f64 sample1D(const Index dimension) = 0;
+
+    /// @brief Generates the 2D sample for the given pair of dimensions of the
+    /// current pixel sample.
+    virtual Vector2D sample2D(const Index dimension) = 0;
+
+    Size mSamplesPerPixel;
+    u64 mSeed;
+
+    Index mPixel;
+    Index mSample;
+    Index mDimension;
+};
+
+using SamplerPtr = std::unique_ptr<Sampler>;
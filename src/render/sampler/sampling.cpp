@@ -0,0 +1,82 @@
+#include "sampling.hpp"
+
+#include <algorithm>
+
+namespace sampling {
+
+u32 reverseBits(u32 value) {
+    value = (value << 16) | (value >> 16);
+    value = ((value & 0x00ff00ff) << 8) | ((value & 0xff00ff00) >> 8);
+    value = ((value & 0x0f0f0f0f) << 4) | ((value & 0xf0f0f0f0) >> 4);
+    value = ((value & 0x33333333) << 2) | ((value & 0xcccccccc) >> 2);
+    value = ((value & 0x55555555) << 1) | ((value & 0xaaaaaaaa) >> 1);
+    return value;
+}
+
+f64 toUnit(const u32 value) {
+    return std::min(static_cast<f64>(value) * 0x1p-32, cOneMinusEpsilon);
+}
+
+u32 permute(u32 index, const u32 count, const u32 seed) {
+    // Kensler's hash-based permutation. Cycle walk within the next power of
+    // two until the index lands inside [0, count).
+    u32 mask = count - 1;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    mask |= mask >> 8;
+    mask |= mask >> 16;
+
+    do {
+        index ^= seed;
+        index *= 0xe170893d;
+        index ^= seed >> 16;
+        index ^= (index & mask) >> 4;
+        index ^= seed >> 8;
+        index *= 0x0929eb3f;
+        index ^= seed >> 23;
+        index ^= (index & mask) >> 1;
+        index *= 1 | seed >> 27;
+        index *= 0x6935fa69;
+        index ^= (index & mask) >> 11;
+        index *= 0x74dcb303;
+        index ^= (index & mask) >> 2;
+        index *= 0x9e501cc3;
+        index ^= (index & mask) >> 2;
+        index *= 0xc860a3df;
+        index &= mask;
+        index ^= index >> 5;
+    } while (index >= count);
+
+    return (index + seed) % count;
+}
+
+u32 owenScramble(u32 value, const u32 seed) {
+    // Hash-based Owen scrambling (Burley 2020). The Laine-Karras style hash
+    // only propagates changes from low to high bits, so apply it to the
+    // reversed value to let each bit depend on the bits above it.
+    value = reverseBits(value);
+
+    value ^= value * 0x3d20adea;
+    value += seed;
+    value *= (seed >> 16) | 1;
+    value ^= value * 0x05526c56;
+    value ^= value * 0x53a22864;
+
+    return reverseBits(value);
+}
+
+u32 sobolFirst(const u32 index) {
+    return reverseBits(index);
+}
+
+u32 sobolSecond(u32 index) {
+    u32 result = 0;
+    for (u32 v = 1u << 31; index != 0; index >>= 1, v ^= v >> 1) {
+        if (index & 1)
+            result ^= v;
+    }
+    return result;
+}
+
+};
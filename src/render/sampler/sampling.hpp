@@ -0,0 +1,41 @@
+#pragma once
+
+#include "common/prelude.hpp"
+#include "common/util/pcg.hpp"
+
+namespace sampling {
+
+/// @brief Largest f64 strictly less than one.
+constexpr f64 cOneMinusEpsilon = 0x1.fffffffffffffp-1;
+
+/// @brief Hashes a list of values into a single well distributed value.
+template <typename... Args>
+u64 hash(const u64 first, const Args... rest) {
+    u64 value = pcg::mix(first);
+    ((value = pcg::mix(value ^ static_cast<u64>(rest))), ...);
+    return value;
+}
+
+/// @brief Reverses the bits of a 32-bit value.
+u32 reverseBits(u32 value);
+
+/// @brief Converts a 32-bit fixed point fraction to a value in [0, 1).
+f64 toUnit(const u32 value);
+
+/// @brief Permutes `index` within [0, count) with the permutation selected by
+/// `seed`. Every seed yields a bijection on [0, count).
+u32 permute(u32 index, const u32 count, const u32 seed);
+
+/// @brief Applies a nested uniform (Owen) scramble to the bits of a 32-bit
+/// fixed point fraction, with the scramble selected by `seed`.
+u32 owenScramble(u32 value, const u32 seed);
+
+/// @brief Computes the first dimension of the Sobol sequence (the van der
+/// Corput sequence) as a 32-bit fixed point fraction.
+u32 sobolFirst(const u32 index);
+
+/// @brief Computes the second dimension of the Sobol sequence as a 32-bit
+/// fixed point fraction.
+u32 sobolSecond(u32 index);
+
+};
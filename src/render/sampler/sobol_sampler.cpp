@@ -0,0 +1,35 @@
+#include "sobol_sampler.hpp"
+
+#include "sampling.hpp"
+
+SobolSampler::SobolSampler(const Size samples_per_pixel, const u64 seed)
+    : Sampler(samples_per_pixel, seed) {
+}
+
+f64 SobolSampler::sample1D(const Index dimension) {
+    const u64 key = sampling::hash(mSeed, mPixel, dimension);
+
+    const u32 index =
+        sampling::owenScramble(static_cast<u32>(mSample), key >> 32);
+    const u32 x = sampling::owenScramble(
+        sampling::sobolFirst(index), static_cast<u32>(key)
+    );
+
+    return sampling::toUnit(x);
+}
+
+Vector2D SobolSampler::sample2D(const Index dimension) {
+    const u64 key = sampling::hash(mSeed, mPixel, dimension);
+    const u64 scramble = pcg::mix(key);
+
+    const u32 index =
+        sampling::owenScramble(static_cast<u32>(mSample), key >> 32);
+    const u32 x = sampling::owenScramble(
+        sampling::sobolFirst(index), static_cast<u32>(scramble)
+    );
+    const u32 y = sampling::owenScramble(
+        sampling::sobolSecond(index), static_cast<u32>(scramble >> 32)
+    );
+
+    return Vector2D(sampling::toUnit(x), sampling::toUnit(y));
+}
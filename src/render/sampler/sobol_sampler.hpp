@@ -0,0 +1,19 @@
+#pragma once
+
+#include "sampler.hpp"
+
+/// @brief Owen-scrambled Sobol sampler. Every 1D dimension uses the van der
+/// Corput sequence and every 2D dimension pair the first two Sobol
+/// dimensions, both with hash-based Owen scrambling. The sample index is
+/// shuffled per dimension with a further Owen scramble, which decorrelates
+/// the dimensions while keeping every power of two prefix stratified.
+class SobolSampler : public Sampler {
+public:
+    SobolSampler(const Size samples_per_pixel, const u64 seed);
+    ~SobolSampler() override = default;
+
+protected:
+    f64 sample1D(const Index dimension) override;
+
+    Vector2D sample2D(const Index dimension) override;
+};
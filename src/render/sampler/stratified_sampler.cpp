@@ -0,0 +1,49 @@
+#include "stratified_sampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/util/pcg.hpp"
+#include "sampling.hpp"
+
+StratifiedSampler::StratifiedSampler(
+    const Size samples_per_pixel, const u64 seed
+)
+    : Sampler(samples_per_pixel, seed) {
+    const Size spp = std::max<Size>(samples_per_pixel, 1);
+
+    mStrataX = static_cast<u32>(std::ceil(std::sqrt(static_cast<f64>(spp))));
+    mStrataY = static_cast<u32>((spp + mStrataX - 1) / mStrataX);
+}
+
+f64 StratifiedSampler::sample1D(const Index dimension) {
+    const u64 key = sampling::hash(mSeed, mPixel, dimension);
+    const u32 count = static_cast<u32>(std::max<Size>(mSamplesPerPixel, 1));
+
+    const u32 stratum =
+        sampling::permute(mSample % count, count, static_cast<u32>(key));
+
+    PCG32 rng(key, mSample);
+    const f64 jitter = rng.uniform<f64>();
+
+    return std::min((stratum + jitter) / count, sampling::cOneMinusEpsilon);
+}
+
+Vector2D StratifiedSampler::sample2D(const Index dimension) {
+    const u64 key = sampling::hash(mSeed, mPixel, dimension);
+    const u32 count = mStrataX * mStrataY;
+
+    const u32 stratum =
+        sampling::permute(mSample % count, count, static_cast<u32>(key));
+    const u32 sx = stratum % mStrataX;
+    const u32 sy = stratum / mStrataX;
+
+    PCG32 rng(key, mSample);
+    const f64 jx = rng.uniform<f64>();
+    const f64 jy = rng.uniform<f64>();
+
+    return Vector2D(
+        std::min((sx + jx) / mStrataX, sampling::cOneMinusEpsilon),
+        std::min((sy + jy) / mStrataY, sampling::cOneMinusEpsilon)
+    );
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "sampler.hpp"
+
+/// @brief Jittered stratified sampler. Each dimension of a pixel is divided
+/// into one stratum per sample (a near square grid of strata in 2D), the
+/// strata are visited in a random order that differs per pixel and dimension,
+/// and each sample is jittered within its stratum.
+class StratifiedSampler : public Sampler {
+public:
+    StratifiedSampler(const Size samples_per_pixel, const u64 seed);
+    ~StratifiedSampler() override = default;
+
+protected:
+    f64 sample1D(const Index dimension) override;
+
+    Vector2D sample2D(const Index dimension) override;
+
+private:
+    // Number of strata along x and y in 2D.
+    u32 mStrataX, mStrataY;
+};
@@ -0,0 +1,47 @@
+#include "render/scene_cache.hpp"
+
+#include <filesystem>
+#include <stdexcept>
+
+#include "common/util/format.hpp"
+
+SceneCache::Entry::Entry(MappedFile file)
+    : mFile(std::move(file)), mReader(mFile.bytes()) {
+}
+
+BinaryReader& SceneCache::Entry::reader() {
+    return mReader;
+}
+
+SceneCache::SceneCache(const std::string& directory) : mDirectory(directory) {
+}
+
+Option<SceneCache::Entry> SceneCache::load(const u64 key) const {
+    const std::string snapshot = path(key);
+    if (!std::filesystem::exists(snapshot))
+        return std::nullopt;
+
+    Entry entry(MappedFile(snapshot.c_str()));
+
+    BinaryReader& reader = entry.reader();
+    if (reader.read<u32>() != MAGIC || reader.read<u32>() != VERSION ||
+        reader.read<u64>() != key)
+        throw std::runtime_error("not a valid scene snapshot: " + snapshot);
+
+    return entry;
+}
+
+BinaryWriter SceneCache::store(const u64 key) const {
+    std::filesystem::create_directories(mDirectory);
+
+    BinaryWriter writer(path(key));
+    writer.write(MAGIC);
+    writer.write(VERSION);
+    writer.write(key);
+
+    return writer;
+}
+
+std::string SceneCache::path(const u64 key) const {
+    return formatted("{}/{}.gscene", mDirectory.c_str(), key);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+
+#include "common/prelude.hpp"
+#include "common/util/binary_io.hpp"
+#include "common/util/mapped_file.hpp"
+
+/// @brief Directory of binary scene snapshots. A snapshot holds the
+/// acceleration data built for a scene, which is the BVH and area
+/// distribution of every mesh primitive and, for SpatialKind::LinearBVH, the
+/// top-level tree. Snapshots are named after a content hash of everything the
+/// data was built from, so an unchanged scene finds its snapshot again and a
+/// changed one never does. The key is computed from the built scene graph,
+/// so a cached scene still runs its script and reads its meshes, and only
+/// the acceleration builds are skipped. The snapshots that render jobs send
+/// to workers use the same header and acceleration data, see
+/// scene_snapshot.hpp.
+class SceneCache {
+public:
+    /// @brief Snapshot read from the cache. The file stays mapped while the
+    /// entry is alive.
+    class Entry {
+    public:
+        explicit Entry(MappedFile file);
+
+        /// @brief Retrieves the reader positioned after the header.
+        BinaryReader& reader();
+
+    private:
+        MappedFile mFile;
+        BinaryReader mReader;
+    };
+
+    explicit SceneCache(const std::string& directory);
+
+    /// @brief Maps the snapshot stored under the key.
+    /// @returns The entry, or std::nullopt if there is no snapshot for the
+    /// key.
+    /// @throws std::runtime_error if the snapshot is not a valid snapshot of
+    /// the current format version.
+    Option<Entry> load(const u64 key) const;
+
+    /// @brief Starts a snapshot for the key and writes its header. The
+    /// snapshot replaces any previous one when the writer is committed.
+    BinaryWriter store(const u64 key) const;
+
+    /// @brief First field of the snapshot header.
+    static constexpr u32 MAGIC = 0x4e435347;  // "GSCN"
+
+    /// @brief Snapshot format version. Part of every key, so snapshots of an
+    /// older format are never loaded.
+    static constexpr u32 VERSION = 2;
+
+private:
+    /// @brief Determines the path of the snapshot for the key.
+    std::string path(const u64 key) const;
+
+    std::string mDirectory;
+};
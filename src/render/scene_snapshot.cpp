@@ -0,0 +1,171 @@
+#include "render/scene_snapshot.hpp"
+
+#include <array>
+#include <map>
+#include <stdexcept>
+
+#include "render/linear_bvh.hpp"
+#include "render/primitive/cuboid_prim.hpp"
+#include "render/primitive/disk_prim.hpp"
+#include "render/primitive/gmesh.hpp"
+#include "render/primitive/mesh_prim.hpp"
+#include "render/primitive/quad_prim.hpp"
+#include "render/primitive/sphere_prim.hpp"
+#include "render/primitive/triangle_prim.hpp"
+#include "render/primitive/tube_prim.hpp"
+#include "render/scene_cache.hpp"
+
+namespace {
+
+/// @brief Writes the 16 elements of the matrix.
+void writeMatrix(BinaryWriter& writer, const Matrix4D& matrix) {
+    writer.writeBytes(matrix.data(), 16 * sizeof(f64));
+}
+
+/// @brief Reads a matrix written by writeMatrix().
+Matrix4D readMatrix(BinaryReader& reader) {
+    return Matrix4D(reader.read<std::array<f64, 16>>());
+}
+
+/// @brief Reads a primitive of an implicit shape written by
+/// Primitive::saveShape().
+PrimitivePtr loadShape(const Primitive::Shape shape, BinaryReader& reader) {
+    switch (shape) {
+    case Primitive::Shape::Sphere:
+        return SpherePrim::loadShape(reader);
+    case Primitive::Shape::Quad:
+        return QuadPrim::loadShape(reader);
+    case Primitive::Shape::Cuboid:
+        return CuboidPrim::loadShape(reader);
+    case Primitive::Shape::Tube:
+        return TubePrim::loadShape(reader);
+    case Primitive::Shape::Disk:
+        return DiskPrim::loadShape(reader);
+    case Primitive::Shape::Triangle:
+        return TrianglePrim::loadShape(reader);
+    default:
+        throw std::runtime_error("invalid primitive shape in scene snapshot");
+    }
+}
+
+}
+
+namespace scene_snapshot {
+
+void write(
+    BinaryWriter& writer,
+    const std::vector<PrimitivePtr>& primitives,
+    const SpatialStructure& world
+) {
+    writer.write(SceneCache::MAGIC);
+    writer.write(SceneCache::VERSION);
+    writer.write<u64>(0);
+
+    std::map<const Material*, u64> material_ids;
+    std::vector<const Material*> materials;
+    for (const PrimitivePtr& primitive : primitives) {
+        const Material* material = primitive->material().get();
+        if (material &&
+            material_ids.try_emplace(material, materials.size()).second)
+            materials.push_back(material);
+    }
+
+    writer.write<u64>(materials.size());
+    for (const Material* material : materials)
+        material->save(writer);
+
+    std::map<const TriangleMesh*, u64> first_by_mesh;
+
+    writer.write<u64>(primitives.size());
+    for (Index i = 0; i < primitives.size(); ++i) {
+        const Primitive& primitive = *primitives[i];
+        const Material* material = primitive.material().get();
+
+        writer.write(material ? material_ids.at(material) : NO_MATERIAL);
+        writeMatrix(writer, primitive.objectToWorld().matrix());
+        writeMatrix(writer, primitive.objectToWorld().inverse());
+
+        const MeshPrim* mesh = dynamic_cast<const MeshPrim*>(&primitive);
+        if (!mesh) {
+            primitive.saveShape(writer);
+            continue;
+        }
+
+        const auto [it, inserted] =
+            first_by_mesh.try_emplace(&mesh->mesh(), i);
+        writer.write(Primitive::Shape::Mesh);
+        writer.write<u64>(it->second);
+        if (inserted)
+            gmesh::save(writer, *mesh);
+    }
+
+    if (const LinearBVH* linear_bvh = dynamic_cast<const LinearBVH*>(&world))
+        linear_bvh->save(writer);
+}
+
+std::vector<PrimitivePtr> read(BinaryReader& reader, SpatialStructure& world) {
+    if (reader.read<u32>() != SceneCache::MAGIC ||
+        reader.read<u32>() != SceneCache::VERSION)
+        throw std::runtime_error("not a valid scene snapshot");
+    reader.read<u64>();
+
+    // Every material takes at least its kind, which bounds the count before
+    // anything is allocated.
+    const u64 material_count = reader.read<u64>();
+    if (material_count > reader.remaining() / sizeof(Material::Kind))
+        throw std::runtime_error("scene snapshot is truncated");
+
+    std::vector<MaterialPtr> materials;
+    materials.reserve(material_count);
+    for (Index i = 0; i < material_count; ++i)
+        materials.push_back(Material::load(reader));
+
+    const u64 primitive_count = reader.read<u64>();
+    if (primitive_count > reader.remaining() / (32 * sizeof(f64)))
+        throw std::runtime_error("scene snapshot is truncated");
+
+    std::vector<PrimitivePtr> primitives;
+    primitives.reserve(primitive_count);
+    for (Index i = 0; i < primitive_count; ++i) {
+        const u64 material = reader.read<u64>();
+        if (material != NO_MATERIAL && material >= materials.size())
+            throw std::runtime_error("invalid material in scene snapshot");
+
+        const Matrix4D matrix = readMatrix(reader);
+        const Matrix4D inverse = readMatrix(reader);
+
+        PrimitivePtr primitive;
+        const Primitive::Shape shape = reader.read<Primitive::Shape>();
+        if (shape == Primitive::Shape::Mesh) {
+            // Instances copy the primitive of the first geometry with their
+            // mesh, which shares its acceleration data.
+            const u64 first = reader.read<u64>();
+            const MeshPrim* shared =
+                (first < i)
+                    ? dynamic_cast<const MeshPrim*>(primitives[first].get())
+                    : nullptr;
+            if (first == i)
+                primitive = gmesh::load(reader);
+            else if (shared)
+                primitive = std::make_shared<MeshPrim>(*shared);
+            else
+                throw std::runtime_error("invalid mesh in scene snapshot");
+        } else {
+            primitive = loadShape(shape, reader);
+        }
+
+        if (material != NO_MATERIAL)
+            primitive->setMaterial(materials[material]);
+        primitive->setObjectToWorld(Transform(matrix, inverse));
+        primitives.push_back(primitive);
+    }
+
+    if (LinearBVH* linear_bvh = dynamic_cast<LinearBVH*>(&world))
+        linear_bvh->load(primitives, reader);
+    else
+        world.build(primitives);
+
+    return primitives;
+}
+
+}
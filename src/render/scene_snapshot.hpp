@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include "common/prelude.hpp"
+#include "common/util/binary_io.hpp"
+#include "render/primitive/primitive.hpp"
+#include "render/spatial_structure.hpp"
+
+/// @brief Self-contained binary snapshot of a built scene, which render jobs
+/// send to worker processes. It extends the format of SceneCache files with
+/// the primitives themselves, so a worker recreates the scene without the
+/// scene graph and without building the BVH of any mesh.
+///
+/// Layout, in native byte order:
+///   u32 magic "GSCN", u32 SceneCache::VERSION, u64 key (always 0),
+///   u64 material count, every material as written by Material::save(),
+///   u64 primitive count, for every primitive:
+///     u64 material index or NO_MATERIAL,
+///     f64 object to world matrix and its inverse (16 values each),
+///     the shape as written by Primitive::saveShape(), or for meshes
+///     Shape::Mesh, the u64 index of the first primitive with the same mesh
+///     and, for that first primitive only, the mesh as written by
+///     gmesh::save(),
+///   the top-level tree as written by LinearBVH::save() if the world is a
+///   LinearBVH.
+/// Primitives that share a material or a mesh share it again when read.
+namespace scene_snapshot {
+
+/// @brief Material index of primitives without a material.
+constexpr u64 NO_MATERIAL = ~u64(0);
+
+/// @brief Writes the primitives and the acceleration data of the world built
+/// over them.
+/// @throws std::runtime_error if a primitive cannot be saved.
+void write(
+    BinaryWriter& writer,
+    const std::vector<PrimitivePtr>& primitives,
+    const SpatialStructure& world
+);
+
+/// @brief Reads the primitives of a snapshot and builds `world` over them,
+/// loading the top-level tree if it is a LinearBVH. The world must be of the
+/// kind the snapshot was written with.
+/// @throws std::runtime_error if the snapshot is malformed.
+std::vector<PrimitivePtr> read(BinaryReader& reader, SpatialStructure& world);
+
+}
@@ -0,0 +1,8 @@
+#include "spatial_structure.hpp"
+
+void SpatialStructure::intersectPacket(
+    std::span<const Ray> rays, std::span<Option<SurfaceInteraction>> hits
+) const {
+    for (Index i = 0; i < rays.size(); ++i)
+        hits[i] = intersect(rays[i]);
+}
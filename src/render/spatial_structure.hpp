@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <vector>
 
 #include "common/prelude.hpp"
@@ -14,4 +15,16 @@ public:
     virtual void build(const std::vector<PrimitivePtr>& prims) = 0;
 
     virtual Option<SurfaceInteraction> intersect(const Ray& ray) const = 0;
+
+    /// @brief Determines whether any primitive is hit by the ray before the
+    /// parameter `tmax`. Returns at the first hit found without building a
+    /// surface interaction.
+    virtual bool occluded(const Ray& ray, const f64 tmax) const = 0;
+
+    /// @brief Determines the closest intersection of every ray of a packet
+    /// and stores it in the matching element of `hits`. The default
+    /// intersects the rays one at a time.
+    virtual void intersectPacket(
+        std::span<const Ray> rays, std::span<Option<SurfaceInteraction>> hits
+    ) const;
 };
@@ -0,0 +1,51 @@
+#include "wide_bvh.hpp"
+
+WideBVH::WideBVH() : WideBVH(SAHParams()) {
+}
+
+WideBVH::WideBVH(const SAHParams& params)
+    : mParams(params), mTree(), mPrimitives() {
+}
+
+void WideBVH::build(const std::vector<PrimitivePtr>& prims) {
+    mPrimitives = prims;
+
+    std::vector<BuildRef> refs;
+    refs.reserve(prims.size());
+    for (Index i = 0; i < prims.size(); ++i) {
+        const AABB bbox = prims[i]->objectToWorld()(prims[i]->aabb());
+        refs.push_back(BuildRef{bbox, bbox.centroid(), i});
+    }
+
+    mTree.build(std::move(refs), mParams, MAX_LEAF_SIZE);
+}
+
+Option<SurfaceInteraction> WideBVH::intersect(const Ray& ray) const {
+    Option<SurfaceInteraction> closest = std::nullopt;
+    Interval bounds(0.001, math::infinity<f64>());
+
+    mTree.traverse(ray, bounds, [&](const Index item, Interval& bounds) {
+        Option<SurfaceInteraction> interaction =
+            mPrimitives[item]->intersectWorld(ray, bounds);
+        if (!interaction)
+            return false;
+
+        closest = std::move(interaction);
+        bounds.max = closest->t;
+        return true;
+    });
+
+    return closest;
+}
+
+bool WideBVH::occluded(const Ray& ray, const f64 tmax) const {
+    const Interval bounds(0.001, tmax);
+
+    return mTree.traverseAny(ray, bounds, [&](const Index item) {
+        return mPrimitives[item]->occludedWorld(ray, bounds);
+    });
+}
+
+f64 WideBVH::sahCost() const {
+    return mTree.sahCost();
+}
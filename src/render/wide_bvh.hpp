@@ -0,0 +1,33 @@
+#pragma once
+
+#include "common/prelude.hpp"
+#include "render/accel/wide_bvh_tree.hpp"
+#include "render/spatial_structure.hpp"
+
+/// @brief Four-wide BVH spatial acceleration structure. The binned SAH tree
+/// of LinearBVH is collapsed into nodes whose four children are tested with
+/// one vectorized slab test and traversed nearest first.
+class WideBVH : public SpatialStructure {
+public:
+    WideBVH();
+    explicit WideBVH(const SAHParams& params);
+    ~WideBVH() override = default;
+
+    void build(const std::vector<PrimitivePtr>& prims) override;
+
+    Option<SurfaceInteraction> intersect(const Ray& ray) const override;
+
+    bool occluded(const Ray& ray, const f64 tmax) const override;
+
+    /// @brief Computes the SAH cost of the binary tree the wide tree was
+    /// collapsed from, normalized by the surface area of the root.
+    f64 sahCost() const;
+
+private:
+    /// @brief Maximum number of primitives in a leaf.
+    static constexpr Size MAX_LEAF_SIZE = 4;
+
+    SAHParams mParams;
+    WideBVHTree mTree;
+    std::vector<PrimitivePtr> mPrimitives;
+};
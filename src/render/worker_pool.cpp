@@ -0,0 +1,396 @@
+#include "render/worker_pool.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "common/util/log.hpp"
+
+namespace {
+
+/// @brief Writes the whole buffer to the socket.
+bool sendAll(const int socket, const void* data, Size size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t written = ::write(socket, bytes, size);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        bytes += written;
+        size -= static_cast<Size>(written);
+    }
+    return true;
+}
+
+/// @brief Reads exactly `size` bytes from the socket.
+bool receiveAll(const int socket, void* data, Size size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t received = ::read(socket, bytes, size);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+        bytes += received;
+        size -= static_cast<Size>(received);
+    }
+    return true;
+}
+
+using AddressList = std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)>;
+
+/// @brief Resolves a "host:port" address to TCP socket addresses. IPv6 hosts
+/// are written in brackets, and an empty host of a passive address stands for
+/// every local interface.
+/// @throws std::runtime_error if the address is malformed or cannot be
+/// resolved.
+AddressList resolve(const std::string& address, const bool passive) {
+    const size_t colon = address.rfind(':');
+    if (colon == std::string::npos)
+        throw std::runtime_error("address must be host:port: " + address);
+
+    std::string host = address.substr(0, colon);
+    const std::string port = address.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']')
+        host = host.substr(1, host.size() - 2);
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+    addrinfo* addresses = nullptr;
+    const int error = ::getaddrinfo(
+        host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &addresses
+    );
+    if (error != 0)
+        throw std::runtime_error(
+            "could not resolve " + address + ": " + ::gai_strerror(error)
+        );
+
+    return AddressList(addresses, &::freeaddrinfo);
+}
+
+/// @brief Connects to a worker listening at the address.
+/// @returns The connected socket.
+/// @throws std::runtime_error if no address of the worker accepts the
+/// connection.
+int connectTo(const std::string& address) {
+    const AddressList addresses = resolve(address, false);
+
+    for (const addrinfo* ai = addresses.get(); ai; ai = ai->ai_next) {
+        const int socket =
+            ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (socket < 0)
+            continue;
+
+        if (::connect(socket, ai->ai_addr, ai->ai_addrlen) == 0) {
+            // Items and results are small messages that must not wait for
+            // more data to fill a segment.
+            const int on = 1;
+            ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            return socket;
+        }
+
+        ::close(socket);
+    }
+
+    throw std::runtime_error("could not connect to worker " + address);
+}
+
+}
+
+WorkerPool::WorkerPool(
+    const Size local_count,
+    const std::vector<std::string>& addresses,
+    std::span<const u8> job,
+    const Start& start
+)
+    : mWorkers() {
+    assertm(
+        local_count + addresses.size() > 0,
+        "worker pool needs at least one worker"
+    );
+
+    // Fork before connecting to remote workers, so that no forked worker
+    // holds their sockets.
+    for (Index i = 0; i < local_count; ++i) {
+        int sockets[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+            shutdown();
+            throw std::runtime_error("could not create worker socket");
+        }
+
+        const pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(sockets[0]);
+            ::close(sockets[1]);
+            shutdown();
+            throw std::runtime_error("could not fork worker");
+        }
+
+        if (pid == 0) {
+            // Drop the coordinator ends inherited from earlier iterations, so
+            // that every worker sees EOF when the coordinator goes away.
+            for (const Worker& worker : mWorkers)
+                ::close(worker.socket);
+            ::close(sockets[0]);
+
+            // Skip the exit handlers, such as the interpreter teardown, which
+            // belong to the coordinator process.
+            try {
+                serve(sockets[1], start);
+            } catch (...) {
+                ::_exit(EXIT_FAILURE);
+            }
+            ::_exit(EXIT_SUCCESS);
+        }
+
+        ::close(sockets[1]);
+        mWorkers.push_back({pid, sockets[0], 0});
+    }
+
+    try {
+        for (const std::string& address : addresses)
+            mWorkers.push_back({-1, connectTo(address), 0});
+    } catch (const std::runtime_error&) {
+        shutdown();
+        throw;
+    }
+
+    // A worker that is gone must surface as an error rather than terminate
+    // the coordinator with SIGPIPE.
+    struct sigaction ignore = {};
+    struct sigaction previous = {};
+    ignore.sa_handler = SIG_IGN;
+    ::sigaction(SIGPIPE, &ignore, &previous);
+
+    const u64 job_size = job.size();
+    for (Index i = 0; i < mWorkers.size(); ++i) {
+        if (!sendAll(mWorkers[i].socket, &job_size, sizeof(job_size)) ||
+            !sendAll(mWorkers[i].socket, job.data(), job.size())) {
+            ::sigaction(SIGPIPE, &previous, nullptr);
+            shutdown();
+            throw std::runtime_error(
+                "could not send the job to worker " + std::to_string(i)
+            );
+        }
+    }
+
+    ::sigaction(SIGPIPE, &previous, nullptr);
+}
+
+WorkerPool::~WorkerPool() {
+    shutdown();
+}
+
+void WorkerPool::run(
+    const Size item_count,
+    const ResultSize& result_size,
+    const Merge& merge
+) {
+    // A worker that dies mid-render must surface as an error rather than
+    // terminate the coordinator with SIGPIPE.
+    struct sigaction ignore = {};
+    struct sigaction previous = {};
+    ignore.sa_handler = SIG_IGN;
+    ::sigaction(SIGPIPE, &ignore, &previous);
+
+    auto fail = [&](const std::string& message) {
+        ::sigaction(SIGPIPE, &previous, nullptr);
+        shutdown();
+        throw std::runtime_error(message);
+    };
+
+    Index next_item = 0;
+    Size pending = 0;
+
+    std::vector<pollfd> fds(mWorkers.size());
+    for (Index i = 0; i < mWorkers.size(); ++i) {
+        fds[i] = {mWorkers[i].socket, POLLIN, 0};
+
+        if (next_item < item_count) {
+            const u64 item = next_item++;
+            if (!sendAll(mWorkers[i].socket, &item, sizeof(item)))
+                fail("could not send work to worker " + std::to_string(i));
+            mWorkers[i].item = item;
+            ++pending;
+        }
+    }
+
+    std::vector<f64> result;
+
+    while (pending > 0) {
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            fail("could not poll workers");
+        }
+
+        for (Index i = 0; i < mWorkers.size(); ++i) {
+            if (fds[i].revents == 0)
+                continue;
+
+            Worker& worker = mWorkers[i];
+            const std::string name = "worker " + std::to_string(i);
+
+            u64 header[2];
+            if (!receiveAll(worker.socket, header, sizeof(header)))
+                fail(name + " exited unexpectedly");
+
+            // The count sizes the buffer, so it is checked before anything
+            // is allocated.
+            if (header[0] != worker.item)
+                fail(name + " returned an item it was not handed");
+            if (header[1] != result_size(worker.item))
+                fail(name + " returned a result of the wrong size");
+
+            result.resize(header[1]);
+            if (!receiveAll(
+                    worker.socket, result.data(), header[1] * sizeof(f64)
+                ))
+                fail(name + " exited unexpectedly");
+
+            // A result the coordinator rejects stops the workers like a
+            // failed worker does.
+            try {
+                merge(worker.item, result);
+            } catch (const std::runtime_error& e) {
+                fail(e.what());
+            }
+            --pending;
+
+            if (next_item < item_count) {
+                const u64 item = next_item++;
+                if (!sendAll(worker.socket, &item, sizeof(item)))
+                    fail("could not send work to " + name);
+                worker.item = item;
+                ++pending;
+            }
+        }
+    }
+
+    ::sigaction(SIGPIPE, &previous, nullptr);
+}
+
+Size WorkerPool::size() const {
+    return mWorkers.size();
+}
+
+int WorkerPool::listen(const std::string& address) {
+    const AddressList addresses = resolve(address, true);
+
+    for (const addrinfo* ai = addresses.get(); ai; ai = ai->ai_next) {
+        const int socket =
+            ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (socket < 0)
+            continue;
+
+        const int on = 1;
+        ::setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        if (::bind(socket, ai->ai_addr, ai->ai_addrlen) == 0 &&
+            ::listen(socket, SOMAXCONN) == 0)
+            return socket;
+
+        ::close(socket);
+    }
+
+    throw std::runtime_error("could not listen on " + address);
+}
+
+u16 WorkerPool::port(const int listener) {
+    sockaddr_storage address = {};
+    socklen_t length = sizeof(address);
+    if (::getsockname(
+            listener, reinterpret_cast<sockaddr*>(&address), &length
+        ) != 0)
+        return 0;
+
+    if (address.ss_family == AF_INET6)
+        return ntohs(reinterpret_cast<const sockaddr_in6&>(address).sin6_port);
+    return ntohs(reinterpret_cast<const sockaddr_in&>(address).sin_port);
+}
+
+void WorkerPool::serveJobs(const int listener, const Start& start) {
+    ::signal(SIGPIPE, SIG_IGN);
+
+    while (true) {
+        const int socket = ::accept(listener, nullptr, nullptr);
+        if (socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            throw std::runtime_error("could not accept coordinator");
+        }
+
+        const int on = 1;
+        ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        Log::i("Serving job");
+        try {
+            serve(socket, start);
+            Log::i("Job done");
+        } catch (const std::exception& e) {
+            Log::e("Job failed: {}", e.what());
+        }
+
+        ::close(socket);
+    }
+}
+
+void WorkerPool::serve(const int socket, const Start& start) {
+    u64 job_size;
+    if (!receiveAll(socket, &job_size, sizeof(job_size)))
+        throw std::runtime_error("could not receive job");
+
+    std::vector<u8> job(job_size);
+    if (!receiveAll(socket, job.data(), job.size()))
+        throw std::runtime_error("could not receive job");
+
+    const Work work = start(job);
+    std::vector<f64> result;
+
+    while (true) {
+        u64 item;
+        if (!receiveAll(socket, &item, sizeof(item)))
+            break;
+
+        result.clear();
+        work(item, result);
+
+        const u64 header[2] = {item, result.size()};
+        if (!sendAll(socket, header, sizeof(header)) ||
+            !sendAll(socket, result.data(), result.size() * sizeof(f64)))
+            throw std::runtime_error("could not send result");
+    }
+}
+
+void WorkerPool::shutdown() {
+    // Closing the socket ends the request loop of the worker.
+    for (const Worker& worker : mWorkers)
+        ::close(worker.socket);
+
+    for (const Worker& worker : mWorkers) {
+        if (worker.pid < 0)
+            continue;
+
+        int status = 0;
+        while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+        }
+    }
+
+    mWorkers.clear();
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/prelude.hpp"
+
+/// @brief Pool of worker processes that process the numbered work items of a
+/// job and stream their results back to the coordinating process.
+///
+/// Workers are either forked by the coordinator and connected to it by a
+/// local stream socket, or separate processes that serve jobs at a TCP
+/// address, such as `Glacier --worker host:port`. The coordinator first sends
+/// every worker the job, an opaque byte string the worker prepares itself
+/// from, so forked workers rely on nothing but the job, exactly like remote
+/// ones. It then sends item indices, and the worker replies with the index,
+/// the number of values in the result and the values themselves. Everything
+/// is sent in native byte order, so all hosts must share it. Items are handed
+/// out one at a time to whichever worker is idle, so results arrive in any
+/// order.
+///
+/// Only the forking thread exists in a forked worker. Other threads of the
+/// coordinator, such as those of a hosting Python interpreter, may hold locks
+/// at the time of the fork, so `start` and the work it returns must not call
+/// into the interpreter or take locks shared with other threads. Forked
+/// workers leave with _exit(), without running exit handlers.
+class WorkerPool {
+public:
+    /// @brief Computes the result of an item in a worker process.
+    using Work = std::function<void(Index item, std::vector<f64>& result)>;
+
+    /// @brief Prepares a worker process for a job and returns the function
+    /// that computes its items.
+    using Start = std::function<Work(std::span<const u8> job)>;
+
+    /// @brief Determines the number of values in the result of an item.
+    using ResultSize = std::function<Size(Index item)>;
+
+    /// @brief Consumes the result of an item in the coordinator process.
+    using Merge =
+        std::function<void(Index item, const std::vector<f64>& result)>;
+
+    /// @brief Forks `local_count` workers, connects to the workers listening
+    /// at `addresses` ("host:port" each) and sends the job to all of them.
+    /// Forked workers prepare the job with `start`.
+    /// @throws std::runtime_error if a worker cannot be started, reached or
+    /// sent the job.
+    WorkerPool(
+        const Size local_count,
+        const std::vector<std::string>& addresses,
+        std::span<const u8> job,
+        const Start& start
+    );
+
+    /// @brief Stops the workers and waits for the forked ones to exit.
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// @brief Distributes the items [0, item_count) over the workers and calls
+    /// `merge` for each result as it arrives. A worker fails if its result is
+    /// not for the item it was handed or does not have `result_size(item)`
+    /// values.
+    /// @throws std::runtime_error if a worker fails, or if `merge` throws
+    /// std::runtime_error for a result. The workers are stopped first.
+    void run(
+        const Size item_count,
+        const ResultSize& result_size,
+        const Merge& merge
+    );
+
+    /// @brief Retrieves the number of workers.
+    Size size() const;
+
+    /// @brief Binds a TCP socket to the address ("host:port") and listens on
+    /// it for coordinators. Port 0 binds a free port.
+    /// @returns The listening socket.
+    /// @throws std::runtime_error if the address cannot be resolved or bound.
+    static int listen(const std::string& address);
+
+    /// @brief Retrieves the port that a listening socket is bound to.
+    static u16 port(const int listener);
+
+    /// @brief Serves the jobs of the coordinators that connect to the
+    /// listening socket, one connection at a time. A job that fails is logged
+    /// and closes its connection. Ignores SIGPIPE, so that a coordinator that
+    /// goes away does not end the process.
+    /// @throws std::runtime_error if the socket stops accepting connections.
+    [[noreturn]] static void serveJobs(const int listener, const Start& start);
+
+private:
+    struct Worker {
+        // Process of a forked worker, or -1 for a remote one.
+        pid_t pid;
+        int socket;
+
+        // Item the worker is computing.
+        Index item;
+    };
+
+    /// @brief Serves one job over a connected socket. Receives the job,
+    /// prepares it with `start` and computes the items sent by the
+    /// coordinator until it closes the socket.
+    /// @throws std::runtime_error if the job cannot be received or prepared,
+    /// or if the connection fails.
+    static void serve(const int socket, const Start& start);
+
+    /// @brief Closes the worker sockets, which stops the workers, and reaps
+    /// the forked ones.
+    void shutdown();
+
+    std::vector<Worker> mWorkers;
+};
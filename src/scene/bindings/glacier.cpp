@@ -19,8 +19,26 @@ void render(
     Log::i("Rendering mode = {}", config.renderingMode);
     Log::i("Sampling kind = {}", config.samplingKind);
     Log::i("Spatial kind = {}", config.spatialKind);
+    Log::i("Integrator kind = {}", config.integratorKind);
 
-    if (config.samplingKind == SamplingKind::Center)
+    if (config.spatialKind == SpatialKind::BVHSAH ||
+        config.spatialKind == SpatialKind::LinearBVH ||
+        config.spatialKind == SpatialKind::WideBVH)
+        Log::i(
+            "SAH bins = {}, traversal cost = {}, intersection cost = {}",
+            config.sahBinCount,
+            config.sahTraversalCost,
+            config.sahIntersectionCost
+        );
+
+    if (config.adaptiveThreshold > 0.0)
+        Log::i(
+            "Samples per pixel = [{}, {}] (adaptive, threshold = {})",
+            config.minSpp,
+            config.maxSpp,
+            config.adaptiveThreshold
+        );
+    else if (config.samplingKind == SamplingKind::Center)
         Log::i(
             "Samples per pixel = {} (overriden to 1 due to SamplingKind)",
             config.samplesPerPixel
@@ -36,6 +54,34 @@ void render(
     else
         Log::i("Trace depth = {}", config.traceDepth);
 
+    if (config.integratorKind != IntegratorKind::Recursive)
+        Log::i("Russian roulette depth = {}", config.rouletteDepth);
+
+    if (config.passSpp > 0 || config.timeBudgetSeconds > 0.0)
+        Log::i(
+            "Progressive passes = {} spp, time budget = {} s",
+            config.passSpp,
+            config.timeBudgetSeconds
+        );
+
+    if (!config.checkpointPath.empty())
+        Log::i(
+            "Checkpoint = {} (every {} s)",
+            config.checkpointPath.c_str(),
+            config.checkpointIntervalSeconds
+        );
+
+    if (!config.resumeFrom.empty())
+        Log::i("Resume from = {}", config.resumeFrom.c_str());
+
+    if (!config.sceneCacheDir.empty())
+        Log::i("Scene cache = {}", config.sceneCacheDir.c_str());
+
+    if (config.workers > 0)
+        Log::i("Workers = {}", config.workers);
+
+    Log::i("Seed = {}", config.seed);
+
     const Image image = pt.render();
 
     image.save(path);
@@ -28,7 +28,9 @@
 namespace py = pybind11;
 
 /// @brief Renders the scene from the given virtual camera to an image file at
-/// the specified path.
+/// the specified path. With Config::workers or Config::workerAddresses set,
+/// the tiles are rendered by worker processes forked from this process or
+/// running on other hosts, which receive a snapshot of the built scene.
 void render(
     const char* path,
     const Camera& camera,
@@ -592,12 +594,25 @@ PYBIND11_MODULE(glacier, m) {
     py::enum_<SamplingKind>(m, "SamplingKind")
         .value("Center", SamplingKind::Center)
         .value("UniformRandom", SamplingKind::UniformRandom)
+        .value("Stratified", SamplingKind::Stratified)
+        .value("Sobol", SamplingKind::Sobol)
+        .value("PMJ02", SamplingKind::PMJ02)
         .export_values();
 
     // SpatialKind enum.
     py::enum_<SpatialKind>(m, "SpatialKind")
         .value("PrimList", SpatialKind::PrimList)
         .value("BVH", SpatialKind::BVH)
+        .value("BVHSAH", SpatialKind::BVHSAH)
+        .value("LinearBVH", SpatialKind::LinearBVH)
+        .value("WideBVH", SpatialKind::WideBVH)
+        .export_values();
+
+    // IntegratorKind enum.
+    py::enum_<IntegratorKind>(m, "IntegratorKind")
+        .value("Recursive", IntegratorKind::Recursive)
+        .value("Iterative", IntegratorKind::Iterative)
+        .value("NextEvent", IntegratorKind::NextEvent)
         .export_values();
 
     // Config struct.
@@ -606,8 +621,34 @@ PYBIND11_MODULE(glacier, m) {
         .def_readwrite("rendering_mode", &Config::renderingMode)
         .def_readwrite("sampling_kind", &Config::samplingKind)
         .def_readwrite("spatial_kind", &Config::spatialKind)
+        .def_readwrite("integrator_kind", &Config::integratorKind)
         .def_readwrite("samples_per_pixel", &Config::samplesPerPixel)
-        .def_readwrite("trace_depth", &Config::traceDepth);
+        .def_readwrite("trace_depth", &Config::traceDepth)
+        .def_readwrite("roulette_depth", &Config::rouletteDepth)
+        .def_readwrite("adaptive_threshold", &Config::adaptiveThreshold)
+        .def_readwrite("min_spp", &Config::minSpp)
+        .def_readwrite("max_spp", &Config::maxSpp)
+        .def_readwrite("spp_heatmap_path", &Config::sppHeatmapPath)
+        .def_readwrite("pass_spp", &Config::passSpp)
+        .def_readwrite("time_budget_seconds", &Config::timeBudgetSeconds)
+        .def_readwrite("snapshot_path", &Config::snapshotPath)
+        .def_readwrite(
+            "snapshot_interval_seconds", &Config::snapshotIntervalSeconds
+        )
+        .def_readwrite("checkpoint_path", &Config::checkpointPath)
+        .def_readwrite(
+            "checkpoint_interval_seconds", &Config::checkpointIntervalSeconds
+        )
+        .def_readwrite("seed", &Config::seed)
+        .def_readwrite("workers", &Config::workers)
+        .def_readwrite("worker_addresses", &Config::workerAddresses)
+        .def_readwrite("threads", &Config::threads)
+        .def_readwrite("tile_size", &Config::tileSize)
+        .def_readwrite("packet_tracing", &Config::packetTracing)
+        .def_readwrite("scene_cache_dir", &Config::sceneCacheDir)
+        .def_readwrite("sah_bin_count", &Config::sahBinCount)
+        .def_readwrite("sah_traversal_cost", &Config::sahTraversalCost)
+        .def_readwrite("sah_intersection_cost", &Config::sahIntersectionCost);
 
     // render function.
     m.def(
@@ -615,14 +656,21 @@ PYBIND11_MODULE(glacier, m) {
         [](const std::string& path,
            const Camera& camera,
            SceneNodePtr root,
-           std::optional<Config> config) {
-            render(
-                path.c_str(), camera, std::move(root), config.value_or(Config())
-            );
+           std::optional<Config> config,
+           std::optional<std::string> resume_from,
+           std::optional<u64> workers) {
+            Config render_config = config.value_or(Config());
+            if (resume_from)
+                render_config.resumeFrom = *resume_from;
+            if (workers)
+                render_config.workers = *workers;
+            render(path.c_str(), camera, std::move(root), render_config);
         },
         py::arg("path"),
         py::arg("camera"),
         py::arg("root"),
-        py::arg("config") = py::none()
+        py::arg("config") = py::none(),
+        py::arg("resume_from") = py::none(),
+        py::arg("workers") = py::none()
     );
 }
@@ -24,7 +24,7 @@ CuboidNode::CuboidNode(
 PrimitivePtr CuboidNode::buildPrimitive() const {
     switch (mPrimitiveKind) {
     case Primitive::Kind::Mesh: {
-        return std::make_unique<MeshPrim>(mGeometry->mesh());
+        return std::make_unique<MeshPrim>(mGeometry->sharedMesh());
     }
     case Primitive::Kind::Implicit: {
         const Cuboid* cuboid = static_cast<Cuboid*>(mGeometry.get());
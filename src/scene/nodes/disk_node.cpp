@@ -23,7 +23,7 @@ DiskNode::DiskNode(
 PrimitivePtr DiskNode::buildPrimitive() const {
     switch (mPrimitiveKind) {
     case Primitive::Kind::Mesh: {
-        return std::make_unique<MeshPrim>(mGeometry->mesh());
+        return std::make_unique<MeshPrim>(mGeometry->sharedMesh());
     }
     case Primitive::Kind::Implicit: {
         const Disk* disk = static_cast<Disk*>(mGeometry.get());
@@ -31,7 +31,7 @@ void GeometryNode::setPrimitiveKind(const Primitive::Kind kind) {
 PrimitivePtr GeometryNode::buildPrimitive() const {
     switch (mPrimitiveKind) {
     case Primitive::Kind::Mesh:
-        return std::make_unique<MeshPrim>(mGeometry->mesh());
+        return std::make_unique<MeshPrim>(mGeometry->sharedMesh());
     default:
         unreachable;
     }
@@ -1,23 +1,16 @@
 #include "mesh_node.hpp"
 
-#include "common/util/files.hpp"
-#include "common/util/log.hpp"
 #include "geometry/mesh.hpp"
-#include "geometry/obj_parser.hpp"
-#include "geometry/triangle_mesh.hpp"
-#include "render/primitive/mesh_prim.hpp"
 
 MeshNode::MeshNode(const char* name, MaterialPtr material, const char* path)
-    : GeometryNode(name, nullptr, material) {
+    : GeometryNode(name, nullptr, material),
+      mAsset(MeshAssetCache::load(path)) {
     mPrimitiveKind = Primitive::Kind::Mesh;
+    mGeometry = std::make_unique<Mesh>(mAsset->mesh());
+}
 
-    const std::string& raw = files::read_to_string(path);
-
-    const ObjData data = ObjParser().parse(raw);
-
-    const ObjObject& obj = data.objects.front();
-
-    const TriangleMesh mesh(obj);
-
-    mGeometry = std::make_unique<Mesh>(mesh);
+PrimitivePtr MeshNode::buildPrimitive() const {
+    if (mPrimitiveKind == Primitive::Kind::Mesh)
+        return std::make_shared<MeshPrim>(mAsset->primitive());
+    return GeometryNode::buildPrimitive();
 }
@@ -1,11 +1,20 @@
 #pragma once
 
-#include <string>
-
 #include "geometry_node.hpp"
+#include "render/primitive/mesh_asset_cache.hpp"
 
+/// @brief Scene node for a triangle mesh file. Wavefront .obj files are
+/// parsed, and .gmesh files are loaded with their prebuilt triangle BVH.
+/// Nodes that reference the same file share one mesh asset.
 class MeshNode : public GeometryNode {
 public:
     MeshNode(const char* name, MaterialPtr material, const char* path);
     ~MeshNode() override = default;
+
+    /// @brief Builds the mesh primitive as a copy of the shared prototype, so
+    /// the triangle BVH is built once per file.
+    PrimitivePtr buildPrimitive() const override;
+
+private:
+    MeshAssetPtr mAsset;
 };
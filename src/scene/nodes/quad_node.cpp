@@ -23,7 +23,7 @@ QuadNode::QuadNode(
 PrimitivePtr QuadNode::buildPrimitive() const {
     switch (mPrimitiveKind) {
     case Primitive::Kind::Mesh: {
-        return std::make_unique<MeshPrim>(mGeometry->mesh());
+        return std::make_unique<MeshPrim>(mGeometry->sharedMesh());
     }
     case Primitive::Kind::Implicit: {
         const Quad* disk = static_cast<Quad*>(mGeometry.get());
@@ -22,7 +22,7 @@ SphereNode::SphereNode(
 PrimitivePtr SphereNode::buildPrimitive() const {
     switch (mPrimitiveKind) {
     case Primitive::Kind::Mesh: {
-        return std::make_unique<MeshPrim>(mGeometry->mesh());
+        return std::make_unique<MeshPrim>(mGeometry->sharedMesh());
     }
     case Primitive::Kind::Implicit: {
         const Sphere* sphere = static_cast<Sphere*>(mGeometry.get());
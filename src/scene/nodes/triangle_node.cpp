@@ -23,7 +23,7 @@ TriangleNode::TriangleNode(
 PrimitivePtr TriangleNode::buildPrimitive() const {
     switch (mPrimitiveKind) {
     case Primitive::Kind::Mesh: {
-        return std::make_unique<MeshPrim>(mGeometry->mesh());
+        return std::make_unique<MeshPrim>(mGeometry->sharedMesh());
     }
     case Primitive::Kind::Implicit: {
         const Triangle* tri = static_cast<Triangle*>(mGeometry.get());
@@ -25,7 +25,7 @@ TubeNode::TubeNode(
 PrimitivePtr TubeNode::buildPrimitive() const {
     switch (mPrimitiveKind) {
     case Primitive::Kind::Mesh: {
-        return std::make_unique<MeshPrim>(mGeometry->mesh());
+        return std::make_unique<MeshPrim>(mGeometry->sharedMesh());
     }
     case Primitive::Kind::Implicit: {
         const Tube* tube = static_cast<Tube*>(mGeometry.get());
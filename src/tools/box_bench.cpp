@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "math/aabb.hpp"
+#include "math/constants.hpp"
+#include "math/traversal_ray.hpp"
+#include "util/format.hpp"
+#include "util/pcg.hpp"
+
+namespace {
+
+/// @brief Number of timed runs of each test. The fastest run is reported.
+constexpr Size cRuns = 3;
+
+/// @brief Number of random boxes every ray is tested against.
+constexpr Size cBoxes = 4096;
+
+/// @brief Number of random rays in the verification.
+constexpr Size cVerifyRays = 20000;
+
+void usage() {
+    eprintln("Usage: BoxBench [ray_count] [--verify]");
+}
+
+/// @brief Slab test with a division per slab and a branch on the order of
+/// the slab parameters, as AABB::checkIntersect() was before TraversalRay.
+bool checkBranching(const AABB& box, const Ray& ray, const Interval& bounds) {
+    Interval slab_bounds = bounds;
+
+    for (Index i = 0; i < 3; ++i) {
+        const Interval& ax = box.axis(i);
+        const f64 dir_inv = 1.0 / ray.direction[i];
+
+        const f64 t0 = (ax.min - ray.origin[i]) * dir_inv;
+        const f64 t1 = (ax.max - ray.origin[i]) * dir_inv;
+
+        if (t0 < t1) {
+            if (t0 > slab_bounds.min)
+                slab_bounds.min = t0;
+            if (t1 < slab_bounds.max)
+                slab_bounds.max = t1;
+        } else {
+            if (t1 > slab_bounds.min)
+                slab_bounds.min = t1;
+            if (t0 < slab_bounds.max)
+                slab_bounds.max = t0;
+        }
+
+        if (slab_bounds.max <= slab_bounds.min)
+            return false;
+    }
+
+    return true;
+}
+
+/// @brief Reference slab test that handles axis-parallel rays explicitly.
+/// The ray is inside the slab of a zero direction component if its origin
+/// is, planes included. Other slabs are computed like in TraversalRay tests,
+/// so only the handling of infinities and NaN can differ.
+bool checkReference(const AABB& box, const Ray& ray, const Interval& bounds) {
+    f64 t_min = bounds.min;
+    f64 t_max = bounds.max;
+
+    for (Index i = 0; i < 3; ++i) {
+        const Interval& ax = box.axis(i);
+
+        if (ray.direction[i] == 0.0) {
+            if (ray.origin[i] < ax.min || ray.origin[i] > ax.max)
+                return false;
+            continue;
+        }
+
+        const f64 dir_inv = 1.0 / ray.direction[i];
+        const f64 t0 = (ax.min - ray.origin[i]) * dir_inv;
+        const f64 t1 = (ax.max - ray.origin[i]) * dir_inv;
+
+        t_min = std::max(t_min, std::min(t0, t1));
+        t_max = std::min(t_max, std::max(t0, t1));
+    }
+
+    return t_min <= t_max;
+}
+
+/// @brief Checks the TraversalRay slab test against the reference on rays
+/// with up to two random zero direction components of either sign, some of
+/// which start on the planes of the box.
+/// @returns Whether every test agreed.
+bool verify(PCG32& rng) {
+    auto random_point = [&]() {
+        return Point3D(
+            rng.uniform<f64>(), rng.uniform<f64>(), rng.uniform<f64>()
+        );
+    };
+
+    Size hits = 0;
+    Size mismatches = 0;
+
+    for (Index i = 0; i < cVerifyRays; ++i) {
+        const AABB box(random_point(), random_point());
+
+        Point3D origin = random_point();
+        Vector3D direction = random_point() - random_point();
+        const Index nonzero_axis = rng.next() % 3;
+        for (Index axis = 0; axis < 3; ++axis) {
+            if (axis != nonzero_axis && rng.next() % 2 == 0)
+                direction[axis] = (rng.next() % 2 == 0) ? 0.0 : -0.0;
+
+            switch (rng.next() % 4) {
+            case 0:
+                origin[axis] = box.axis(axis).min;
+                break;
+            case 1:
+                origin[axis] = box.axis(axis).max;
+                break;
+            }
+        }
+
+        const Ray ray(origin, direction);
+        const Interval bounds(0.0, math::infinity<f64>());
+
+        const bool expected = checkReference(box, ray, bounds);
+        const bool hit = box.checkIntersect(TraversalRay(ray), bounds);
+        hits += expected;
+
+        if (hit != expected && mismatches++ < 10)
+            eprintln("TraversalRay test disagrees on ray {}", i);
+    }
+
+    println(
+        "Verified {} box tests, {} hits, {} mismatches",
+        cVerifyRays,
+        hits,
+        mismatches
+    );
+    return mismatches == 0;
+}
+
+/// @brief Times the fastest of several runs of the test, which tests every
+/// ray against every box and returns the number of hits.
+void measure(
+    const char* name, const Size tests, const std::function<Size()>& run
+) {
+    f64 best = 0.0;
+    Size hits = 0;
+    for (Index i = 0; i < cRuns; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        hits = run();
+        const std::chrono::duration<f64> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = (i == 0) ? elapsed.count() : std::min(best, elapsed.count());
+    }
+
+    println(
+        "{}: {} s, {} M boxes/s, {} hits",
+        name,
+        best,
+        static_cast<f64>(tests) / 1.0e6 / best,
+        hits
+    );
+}
+
+}
+
+/// @brief Measures the ray-box slab test throughput, in boxes tested per
+/// second, of AABB::checkIntersect() with a TraversalRay prepared once per
+/// ray, with a plain Ray, which prepares it per box, and of the branching
+/// test it replaced. Rays run between random points of the unit cube, and
+/// boxes are small and random within it, so most tests miss as in BVH
+/// traversal. With --verify, the handling of axis-parallel rays is first
+/// checked against a reference.
+int main(int argc, char** argv) {
+    const bool verify_tests =
+        (argc > 1 && std::strcmp(argv[argc - 1], "--verify") == 0);
+    const int arg_count = verify_tests ? argc - 1 : argc;
+    if (arg_count > 2) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const Size ray_count =
+        (arg_count == 2) ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    if (ray_count == 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    PCG32 rng(1, 0);
+    if (verify_tests && !verify(rng))
+        return EXIT_FAILURE;
+
+    auto random_point = [&]() {
+        return Point3D(
+            rng.uniform<f64>(), rng.uniform<f64>(), rng.uniform<f64>()
+        );
+    };
+    auto random_offset = [&]() {
+        return Vector3D(
+                   rng.uniform<f64>(), rng.uniform<f64>(), rng.uniform<f64>()
+               ) *
+               0.1;
+    };
+
+    std::vector<AABB> boxes;
+    for (Index i = 0; i < cBoxes; ++i) {
+        const Point3D p = random_point();
+        boxes.emplace_back(p, p + random_offset());
+    }
+
+    std::vector<Ray> rays;
+    for (Index i = 0; i < ray_count; ++i) {
+        const Point3D origin = random_point();
+        rays.emplace_back(origin, random_point() - origin);
+    }
+
+    const Interval bounds(0.0, math::infinity<f64>());
+    const Size tests = ray_count * cBoxes;
+
+    println("{} rays x {} boxes", ray_count, cBoxes);
+
+    measure("TraversalRay", tests, [&]() {
+        Size hits = 0;
+        for (const Ray& ray : rays) {
+            const TraversalRay traversal_ray(ray);
+            for (const AABB& box : boxes)
+                hits += box.checkIntersect(traversal_ray, bounds);
+        }
+        return hits;
+    });
+
+    measure("Ray", tests, [&]() {
+        Size hits = 0;
+        for (const Ray& ray : rays) {
+            for (const AABB& box : boxes)
+                hits += box.checkIntersect(ray, bounds);
+        }
+        return hits;
+    });
+
+    measure("Branching", tests, [&]() {
+        Size hits = 0;
+        for (const Ray& ray : rays) {
+            for (const AABB& box : boxes)
+                hits += checkBranching(box, ray, bounds);
+        }
+        return hits;
+    });
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/util/format.hpp"
+#include "render/camera.hpp"
+#include "render/config.hpp"
+#include "render/material/dielectric.hpp"
+#include "render/material/emissive.hpp"
+#include "render/material/lambertian.hpp"
+#include "render/material/mirror_specular.hpp"
+#include "render/material/specular.hpp"
+#include "render/pathtracer.hpp"
+#include "render/worker_pool.hpp"
+#include "scene/nodes/cuboid_node.hpp"
+#include "scene/nodes/disk_node.hpp"
+#include "scene/nodes/mesh_node.hpp"
+#include "scene/nodes/quad_node.hpp"
+#include "scene/nodes/sphere_node.hpp"
+#include "scene/nodes/triangle_node.hpp"
+#include "scene/nodes/tube_node.hpp"
+#include "scene/scene_graph.hpp"
+
+namespace {
+
+/// @brief Number of forked workers of the distributed renders.
+constexpr Size cForkedWorkers = 2;
+
+/// @brief Spatial structures that are checked. LinearBVH workers load the
+/// top-level tree from the job, the others rebuild it.
+constexpr SpatialKind cSpatialKinds[] = {
+    SpatialKind::BVH,
+    SpatialKind::LinearBVH,
+    SpatialKind::WideBVH,
+};
+
+/// @brief Image resolution.
+constexpr Size cWidth = 64;
+constexpr Size cHeight = 48;
+
+void usage() {
+    eprintln("Usage: DistributedCheck <cow_obj_file_path>");
+}
+
+/// @brief Builds a scene with every primitive shape and material kind, two
+/// instances of the cow mesh and nested transforms.
+SceneGraph buildScene(const char* cow_path) {
+    SceneGraph scene;
+
+    const auto grey = std::make_shared<Lambertian>(Vector3D(0.5, 0.5, 0.5));
+    const auto red = std::make_shared<Lambertian>(Vector3D(0.7, 0.2, 0.2));
+    const auto glossy =
+        std::make_shared<Specular>(Vector3D(0.8, 0.8, 0.3), 0.3);
+    const auto mirror =
+        std::make_shared<MirrorSpecular>(Vector3D(0.9, 0.9, 0.9));
+    const auto glass = std::make_shared<Dielectric>(1.5);
+    const auto light = std::make_shared<Emissive>(Vector3D(4.0, 4.0, 4.0));
+
+    scene.root()->addChild(std::make_shared<QuadNode>(
+        "floor",
+        grey,
+        Point3D(-10.0, -2.0, -10.0),
+        Vector3D(20.0, 0.0, 0.0),
+        Vector3D(0.0, 0.0, 20.0)
+    ));
+    scene.root()->addChild(std::make_shared<SphereNode>(
+        "light", light, Point3D(0.0, 5.0, 0.0), 1.5
+    ));
+    scene.root()->addChild(std::make_shared<SphereNode>(
+        "glass", glass, Point3D(-2.0, -1.0, -1.0), 0.8
+    ));
+    scene.root()->addChild(std::make_shared<DiskNode>(
+        "disk",
+        mirror,
+        Point3D(0.0, 0.0, 4.0),
+        Vector3D(2.0, 0.0, 0.0),
+        Vector3D(0.0, 2.0, 0.0)
+    ));
+    scene.root()->addChild(std::make_shared<TriangleNode>(
+        "triangle",
+        glossy,
+        Point3D(2.0, -2.0, 2.0),
+        Vector3D(2.0, 0.0, 0.0),
+        Vector3D(0.0, 3.0, 0.0)
+    ));
+
+    const auto cow = std::make_shared<MeshNode>("cow", red, cow_path);
+    cow->transform().t(-1.0, 0.0, 0.0);
+    scene.root()->addChild(cow);
+
+    const auto cuboid = std::make_shared<CuboidNode>("cuboid", glossy);
+    cuboid->transform().t(2.0, 0.0, 0.0);
+    cuboid->transform().r(0.0, 30.0, 0.0);
+    scene.root()->addChild(cuboid);
+
+    const auto tube = std::make_shared<TubeNode>("tube", grey);
+    tube->transform().t(0.0, 2.0, 0.0);
+    tube->transform().r(60.0, 0.0, 0.0);
+    cuboid->addChild(tube);
+
+    const auto instance = std::make_shared<MeshNode>("cow", mirror, cow_path);
+    instance->transform().t(0.0, 1.5, 0.0);
+    instance->transform().s(0.5, 0.5, 0.5);
+    tube->addChild(instance);
+
+    return scene;
+}
+
+/// @brief Forks a worker that serves jobs over TCP on a free local port,
+/// like `Glacier --worker 127.0.0.1:<port>`.
+/// @returns The process of the worker and its address.
+std::pair<pid_t, std::string> startRemoteWorker() {
+    const int listener = WorkerPool::listen("127.0.0.1:0");
+    const std::string address =
+        "127.0.0.1:" + std::to_string(WorkerPool::port(listener));
+
+    const pid_t pid = ::fork();
+    if (pid < 0)
+        throw std::runtime_error("could not fork worker");
+
+    if (pid == 0) {
+        try {
+            WorkerPool::serveJobs(listener, &Pathtracer::startWorker);
+        } catch (...) {
+        }
+        ::_exit(EXIT_FAILURE);
+    }
+
+    ::close(listener);
+    return {pid, address};
+}
+
+}
+
+/// @brief Renders a scene with every primitive shape and material kind in
+/// this process and with forked and remote workers, for several spatial
+/// structures, and checks that the images are identical. The workers only
+/// receive the scene snapshot of the job, so this covers the snapshot of
+/// every shape, material, mesh instance and transform.
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const SceneGraph scene = buildScene(argv[1]);
+    const Camera camera(
+        Point3D(0.0, 1.0, -8.0),
+        Point3D(0.0, 0.0, 0.0),
+        Vector3D(0.0, 1.0, 0.0),
+        60.0,
+        cWidth,
+        cHeight
+    );
+
+    const auto [worker_pid, worker_address] = startRemoteWorker();
+
+    Config config;
+    config.integratorKind = IntegratorKind::NextEvent;
+    config.samplesPerPixel = 4;
+    config.traceDepth = 8;
+    config.tileSize = 8;
+    config.seed = 7;
+
+    bool identical = true;
+
+    // The worker must be stopped on failure too, or it would keep the test
+    // running.
+    try {
+        for (const SpatialKind kind : cSpatialKinds) {
+            config.spatialKind = kind;
+            Pathtracer pathtracer(scene, camera, config);
+
+            pathtracer.config.workers = 0;
+            pathtracer.config.workerAddresses.clear();
+            const Image single = pathtracer.render();
+
+            pathtracer.config.workers = cForkedWorkers;
+            pathtracer.config.workerAddresses = {worker_address};
+            const Image distributed = pathtracer.render();
+
+            const bool equal =
+                std::ranges::equal(single.data(), distributed.data());
+            println("{}: {}", kind, equal ? "identical" : "different");
+            identical = identical && equal;
+        }
+    } catch (const std::exception& e) {
+        eprintln("Error: {}", e.what());
+        identical = false;
+    }
+
+    ::kill(worker_pid, SIGTERM);
+    ::waitpid(worker_pid, nullptr, 0);
+
+    return identical ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+
+#include "common/geometry/obj_mesh_reader.hpp"
+#include "common/geometry/obj_parser.hpp"
+#include "common/math/constants.hpp"
+#include "common/util/files.hpp"
+#include "common/util/format.hpp"
+#include "common/util/pcg.hpp"
+#include "render/primitive/gmesh.hpp"
+#include "render/primitive/mesh_prim.hpp"
+
+namespace {
+
+/// @brief Number of random rays traced against both meshes when verifying.
+constexpr Size cVerifyRays = 10000;
+
+void usage() {
+    eprintln("Usage: obj2gmesh <obj_file_path> <gmesh_file_path> [--verify]");
+}
+
+/// @brief Retrieves the seconds elapsed since `start`.
+f64 secondsSince(const std::chrono::steady_clock::time_point start) {
+    const std::chrono::duration<f64> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+[[noreturn]] void mismatch(const char* what) {
+    throw std::runtime_error(formatted("round trip mismatch: {}", what));
+}
+
+/// @brief Checks that the loaded mesh matches the ObjParser reading of the
+/// file: the same positions, and triangles that fan out from the first
+/// corner of every face.
+void verifyAgainstParser(const char* obj_path, const TriangleMesh& mesh) {
+    const ObjData data = ObjParser().parse(files::read_to_string(obj_path));
+    if (data.objects.empty())
+        mismatch("the file has no objects");
+
+    const ObjObject& object = data.objects.front();
+    if (object.vertexPositions.size() != mesh.vertices().size())
+        mismatch("vertex count");
+
+    for (Index i = 0; i < mesh.vertices().size(); ++i) {
+        const Point3D& p = object.vertexPositions[i];
+        const Point3D& q = mesh.vertices()[i].p;
+        if (p.x != q.x || p.y != q.y || p.z != q.z)
+            mismatch("vertex position");
+    }
+
+    Index t = 0;
+    for (const obj::Face& face : object.faces) {
+        for (Index i = 2; i < face.vertices.size(); ++i, ++t) {
+            if (t >= mesh.triangles().size())
+                mismatch("triangle count");
+
+            const TriangleMesh::Tri& tri = mesh.triangles()[t];
+            if (tri.a != static_cast<Index>(face.vertices[0].position) ||
+                tri.b != static_cast<Index>(face.vertices[i - 1].position) ||
+                tri.c != static_cast<Index>(face.vertices[i].position))
+                mismatch("triangle indices");
+        }
+    }
+
+    if (t != mesh.triangles().size())
+        mismatch("triangle count");
+}
+
+/// @brief Checks that the loaded primitive matches the converted one: the
+/// same vertex attributes, area and hits for random rays through the bounds.
+void verifyAgainstPrim(const MeshPrim& expected, const MeshPrim& loaded) {
+    const TriangleMesh& a = expected.mesh();
+    const TriangleMesh& b = loaded.mesh();
+
+    if (a.vertices().size() != b.vertices().size() ||
+        a.triangles().size() != b.triangles().size())
+        mismatch("mesh size");
+
+    for (Index i = 0; i < a.vertices().size(); ++i) {
+        const Vertex& u = a.vertices()[i];
+        const Vertex& v = b.vertices()[i];
+        if (u.n.x != v.n.x || u.n.y != v.n.y || u.n.z != v.n.z ||
+            u.uv.x != v.uv.x || u.uv.y != v.uv.y)
+            mismatch("vertex attributes");
+    }
+
+    if (expected.area() != loaded.area())
+        mismatch("area");
+
+    const AABB& bbox = expected.aabb();
+    const Point3D center = bbox.centroid();
+    const f64 radius = 0.5 * (bbox.max() - bbox.min()).length() + 1.0;
+
+    // Rays run from random points around the mesh to random points within
+    // its bounds.
+    PCG32 rng(1, 0);
+    auto random_offset = [&]() {
+        return Vector3D(
+            rng.uniform<f64>() - 0.5,
+            rng.uniform<f64>() - 0.5,
+            rng.uniform<f64>() - 0.5
+        );
+    };
+
+    for (Index i = 0; i < cVerifyRays; ++i) {
+        const Point3D target =
+            center + random_offset() * (bbox.max() - bbox.min());
+        const Point3D origin = center + random_offset().normalize() * radius;
+        const Ray ray(origin, target - origin);
+        const Interval bounds(0.0, math::infinity<f64>());
+
+        const Option<SurfaceInteraction> x = expected.intersect(ray, bounds);
+        const Option<SurfaceInteraction> y = loaded.intersect(ray, bounds);
+        if (x.has_value() != y.has_value() || (x && x->t != y->t))
+            mismatch("ray intersection");
+    }
+}
+
+}
+
+/// @brief Converts the first object of a Wavefront .obj file to a .gmesh file
+/// with a prebuilt triangle BVH. With --verify, the written file is read back
+/// and compared with the ObjParser reading of the input.
+int main(int argc, char** argv) {
+    const bool verify = (argc == 4 && std::strcmp(argv[3], "--verify") == 0);
+    if (argc != 3 && !verify) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const char* obj_path = argv[1];
+    const char* gmesh_path = argv[2];
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        const MeshPrim prim(ObjMeshReader().read(obj_path));
+        const f64 build_seconds = secondsSince(start);
+
+        gmesh::write(gmesh_path, prim);
+
+        println(
+            "{}: {} vertices, {} triangles, parsed and built in {} s, "
+            "{} MiB written",
+            gmesh_path,
+            prim.mesh().vertices().size(),
+            prim.mesh().triangles().size(),
+            build_seconds,
+            std::filesystem::file_size(gmesh_path) / (1024.0 * 1024.0)
+        );
+
+        if (verify) {
+            start = std::chrono::steady_clock::now();
+            const std::unique_ptr<MeshPrim> loaded = gmesh::read(gmesh_path);
+            const f64 load_seconds = secondsSince(start);
+
+            verifyAgainstParser(obj_path, loaded->mesh());
+            verifyAgainstPrim(prim, *loaded);
+
+            println("Verified, loaded in {} s", load_seconds);
+        }
+    } catch (const std::runtime_error& e) {
+        eprintln("{}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
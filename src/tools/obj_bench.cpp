@@ -0,0 +1,128 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "geometry/obj_mesh_reader.hpp"
+#include "geometry/obj_parser.hpp"
+#include "geometry/triangle_mesh.hpp"
+#include "util/files.hpp"
+#include "util/format.hpp"
+
+namespace {
+
+void usage() {
+    eprintln("Usage: ObjBench <obj_file_path>");
+}
+
+/// @brief Retrieves the peak resident set size of the process in MiB.
+f64 peakResidentMiB() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    // Reported in bytes.
+    return static_cast<f64>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+    // Reported in KiB.
+    return static_cast<f64>(usage.ru_maxrss) / 1024.0;
+#endif
+}
+
+/// @brief Loads the mesh in a child process, so that every loader starts
+/// from the same resident set and its peak is measured in isolation.
+/// Throughput is the size of the file over the load time.
+bool measure(
+    const std::string& name,
+    const Size file_size,
+    const std::function<TriangleMesh()>& load
+) {
+    const pid_t pid = ::fork();
+    if (pid < 0)
+        return false;
+
+    if (pid == 0) {
+        try {
+            const f64 baseline = peakResidentMiB();
+            const auto start = std::chrono::steady_clock::now();
+
+            const TriangleMesh mesh = load();
+
+            const std::chrono::duration<f64> elapsed =
+                std::chrono::steady_clock::now() - start;
+            const f64 throughput =
+                static_cast<f64>(file_size) / 1.0e6 / elapsed.count();
+            println(
+                "{}: {} vertices, {} triangles in {} s ({} MB/s), "
+                "peak RSS {} MiB ({} MiB before loading)",
+                name,
+                mesh.vertices().size(),
+                mesh.triangles().size(),
+                elapsed.count(),
+                throughput,
+                peakResidentMiB(),
+                baseline
+            );
+        } catch (const std::runtime_error& e) {
+            eprintln("{}: {}", name, e.what());
+            ::_exit(EXIT_FAILURE);
+        }
+
+        // _exit skips the stream flush of a normal exit.
+        std::cout.flush();
+        ::_exit(EXIT_SUCCESS);
+    }
+
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+}
+
+/// @brief Compares the load time, throughput and peak memory of the OBJ
+/// loaders. ObjMeshReader is measured on one thread and on every hardware
+/// thread.
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const char* path = argv[1];
+
+    std::error_code error;
+    const Size file_size = std::filesystem::file_size(path, error);
+    if (error) {
+        eprintln("{}: {}", path, error.message());
+        return EXIT_FAILURE;
+    }
+
+    const Size threads = std::max<Size>(std::thread::hardware_concurrency(), 1);
+
+    const bool parsed = measure("ObjParser", file_size, [&]() {
+        const std::string raw = files::read_to_string(path);
+        const ObjData data = ObjParser().parse(raw);
+        if (data.objects.empty())
+            throw std::runtime_error("no objects");
+        return TriangleMesh(data.objects.front());
+    });
+
+    const bool read = measure("ObjMeshReader (1 thread)", file_size, [&]() {
+        return ObjMeshReader(1).read(path);
+    });
+
+    const bool read_parallel = measure(
+        formatted("ObjMeshReader ({} threads)", threads),
+        file_size,
+        [&]() { return ObjMeshReader(threads).read(path); }
+    );
+
+    return (parsed && read && read_parallel) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
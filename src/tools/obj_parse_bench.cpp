@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include "geometry/obj_mesh_reader.hpp"
+#include "geometry/obj_parser.hpp"
+#include "util/files.hpp"
+#include "util/format.hpp"
+
+namespace {
+
+/// @brief Number of timed runs of each parser. The fastest run is reported.
+constexpr Size cRuns = 3;
+
+void usage() {
+    eprintln("Usage: ObjParseBench <obj_file_path> [copies]");
+}
+
+/// @brief Builds .obj text with `copies` copies of the first object of the
+/// file, so that small meshes scale up to millions of faces. Every copy
+/// indexes its own vertices.
+std::string scale(const ObjData& data, const Size copies) {
+    if (data.objects.empty())
+        throw std::runtime_error("no objects");
+
+    const ObjObject& object = data.objects.front();
+    const i64 vertex_count = object.vertexPositions.size();
+
+    ObjObject scaled;
+    scaled.vertexPositions.reserve(copies * object.vertexPositions.size());
+    scaled.faces.reserve(copies * object.faces.size());
+
+    for (Index copy = 0; copy < copies; ++copy) {
+        const i64 offset = copy * vertex_count;
+
+        scaled.vertexPositions.insert(
+            std::end(scaled.vertexPositions),
+            std::begin(object.vertexPositions),
+            std::end(object.vertexPositions)
+        );
+
+        for (obj::Face face : object.faces) {
+            for (obj::FaceVertex& vertex : face.vertices)
+                vertex.position += offset;
+            scaled.faces.push_back(std::move(face));
+        }
+    }
+
+    return formatted("{}", scaled);
+}
+
+/// @brief Times the fastest of several runs of the parser over the text.
+void measure(
+    const char* name,
+    const std::string& text,
+    const Size faces,
+    const std::function<void()>& parse
+) {
+    f64 best = 0.0;
+    for (Index run = 0; run < cRuns; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        parse();
+        const std::chrono::duration<f64> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = (run == 0) ? elapsed.count() : std::min(best, elapsed.count());
+    }
+
+    println(
+        "{}: {} s, {} MB/s, {} M faces/s",
+        name,
+        best,
+        static_cast<f64>(text.size()) / 1.0e6 / best,
+        static_cast<f64>(faces) / 1.0e6 / best
+    );
+}
+
+}
+
+/// @brief Measures the parse throughput of the OBJ parsers over a mesh
+/// scaled up in memory. File reading is excluded.
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const Size copies = (argc == 3) ? std::strtoull(argv[2], nullptr, 10) : 200;
+    if (copies == 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    try {
+        const std::string raw = files::read_to_string(argv[1]);
+        const std::string text = scale(ObjParser().parse(raw), copies);
+
+        const ObjData data = ObjParser().parse(text);
+        const Size faces = data.objects.front().faces.size();
+        println(
+            "{} copies: {} MB, {} vertices, {} faces",
+            copies,
+            static_cast<f64>(text.size()) / 1.0e6,
+            data.objects.front().vertexPositions.size(),
+            faces
+        );
+
+        measure("ObjParser", text, faces, [&]() { ObjParser().parse(text); });
+        measure("ObjMeshReader", text, faces, [&]() {
+            ObjMeshReader(1).parse(text);
+        });
+    } catch (const std::runtime_error& e) {
+        eprintln("{}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "common/util/format.hpp"
+#include "common/util/pcg.hpp"
+#include "render/camera.hpp"
+#include "render/config.hpp"
+#include "render/material/emissive.hpp"
+#include "render/material/lambertian.hpp"
+#include "render/pathtracer.hpp"
+#include "scene/nodes/cuboid_node.hpp"
+#include "scene/nodes/mesh_node.hpp"
+#include "scene/nodes/quad_node.hpp"
+#include "scene/nodes/sphere_node.hpp"
+#include "scene/nodes/tube_node.hpp"
+#include "scene/scene_graph.hpp"
+
+namespace {
+
+/// @brief Number of timed renders of each configuration. The fastest render
+/// is reported.
+constexpr Size cRuns = 3;
+
+/// @brief Number of random spheres in the scene.
+constexpr Size cSpheres = 400;
+
+/// @brief Spatial structures that are compared. PrimList is left out, as it
+/// tests every primitive for every ray and takes orders of magnitude longer.
+constexpr SpatialKind cSpatialKinds[] = {
+    SpatialKind::BVH,
+    SpatialKind::BVHSAH,
+    SpatialKind::LinearBVH,
+    SpatialKind::WideBVH,
+};
+
+/// @brief Integrators that are compared.
+constexpr IntegratorKind cIntegratorKinds[] = {
+    IntegratorKind::Recursive,
+    IntegratorKind::Iterative,
+    IntegratorKind::NextEvent,
+};
+
+/// @brief Trace depth of the packet comparison, which only traces the camera
+/// rays.
+constexpr u64 cPrimaryDepth = 1;
+
+/// @brief Image resolution.
+constexpr Size cWidth = 200;
+constexpr Size cHeight = 120;
+
+void usage() {
+    eprintln("Usage: RenderBench [samples_per_pixel] [cow_obj_file_path]");
+}
+
+/// @brief Scene that is rendered, and the camera it is rendered from.
+struct BenchScene {
+    const char* name;
+    SceneGraph graph;
+    Camera camera;
+};
+
+/// @brief Builds a field of small random spheres over a floor, lit by a
+/// spherical light. The scene only depends on the fixed seed.
+SceneGraph buildSpheres() {
+    SceneGraph scene;
+    PCG32 rng(1, 0);
+
+    const auto grey = std::make_shared<Lambertian>(Vector3D(0.5, 0.5, 0.5));
+    const auto green = std::make_shared<Lambertian>(Vector3D(0.3, 0.6, 0.4));
+    const auto light = std::make_shared<Emissive>(Vector3D(4.0, 4.0, 4.0));
+
+    for (Index i = 0; i < cSpheres; ++i) {
+        const Point3D center(
+            -8.0 + 16.0 * rng.uniform<f64>(),
+            -4.0 + 8.0 * rng.uniform<f64>(),
+            2.0 + 4.0 * rng.uniform<f64>()
+        );
+        const f64 radius = 0.05 + 0.2 * rng.uniform<f64>();
+        scene.root()->addChild(
+            std::make_shared<SphereNode>("sphere", green, center, radius)
+        );
+    }
+
+    scene.root()->addChild(std::make_shared<QuadNode>(
+        "floor",
+        grey,
+        Point3D(-20.0, -5.0, -20.0),
+        Vector3D(40.0, 0.0, 0.0),
+        Vector3D(0.0, 0.0, 40.0)
+    ));
+    scene.root()->addChild(std::make_shared<SphereNode>(
+        "light", light, Point3D(0.0, 4.0, -1.0), 1.0
+    ));
+
+    return scene;
+}
+
+/// @brief Builds the scene of examples/cow.py, with the mesh read from
+/// `path`.
+SceneGraph buildCow(const char* path) {
+    SceneGraph scene;
+    const auto mat = std::make_shared<Lambertian>(Vector3D(0.7, 0.5, 0.5));
+    scene.root()->addChild(std::make_shared<MeshNode>("mesh", mat, path));
+    return scene;
+}
+
+/// @brief Builds the nested transforms of examples/hierarchy.py.
+SceneGraph buildHierarchy() {
+    SceneGraph scene;
+
+    const auto red = std::make_shared<Lambertian>(Vector3D(1.0, 0.0, 0.0));
+    const auto green = std::make_shared<Lambertian>(Vector3D(0.0, 1.0, 0.0));
+    const auto blue = std::make_shared<Lambertian>(Vector3D(0.0, 0.0, 1.0));
+
+    const auto root = std::make_shared<SceneNode>("root");
+    root->transform().t(-3.0, -3.0, 0.0);
+    scene.root()->addChild(root);
+
+    const auto sphere = std::make_shared<SphereNode>("sphere", red);
+    sphere->transform().t(1.5, 1.5, 0.0);
+    sphere->transform().r(0.0, 0.0, -20.0);
+    root->addChild(sphere);
+
+    const auto cuboid = std::make_shared<CuboidNode>("cuboid", green);
+    cuboid->transform().t(1.5, 1.5, 0.0);
+    cuboid->transform().r(45.0, 0.0, 0.0);
+    sphere->addChild(cuboid);
+
+    const auto tube = std::make_shared<TubeNode>("tube", blue);
+    tube->transform().t(1.5, 1.5, 0.0);
+    tube->transform().r(0.0, 20.0, 0.0);
+    cuboid->addChild(tube);
+
+    return scene;
+}
+
+/// @brief Builds a camera at `look_from` that looks at the origin.
+Camera makeCamera(const Point3D& look_from) {
+    return Camera(
+        look_from,
+        Point3D(0.0, 0.0, 0.0),
+        Vector3D(0.0, 1.0, 0.0),
+        90.0,
+        cWidth,
+        cHeight
+    );
+}
+
+/// @brief Builds the acceleration structure and renders the scene with the
+/// configuration, and reports the build time, the time of the fastest of
+/// several renders and the camera samples it rendered per second.
+template <typename T>
+void measure(
+    const T& name,
+    const SceneGraph& scene,
+    const Camera& camera,
+    const Config& config
+) {
+    const auto start = std::chrono::steady_clock::now();
+    const Pathtracer pathtracer(scene, camera, config);
+    const std::chrono::duration<f64> build_time =
+        std::chrono::steady_clock::now() - start;
+
+    f64 best = 0.0;
+    for (Index i = 0; i < cRuns; ++i) {
+        const auto render_start = std::chrono::steady_clock::now();
+        pathtracer.render();
+        const std::chrono::duration<f64> elapsed =
+            std::chrono::steady_clock::now() - render_start;
+        best = (i == 0) ? elapsed.count() : std::min(best, elapsed.count());
+    }
+
+    const f64 samples =
+        static_cast<f64>(cWidth * cHeight * config.samplesPerPixel);
+    println(
+        "{}: build {} s, render {} s, {} M samples/s",
+        name,
+        build_time.count(),
+        best,
+        samples / 1.0e6 / best
+    );
+}
+
+}
+
+/// @brief Renders the random spheres, the cow and the hierarchy examples
+/// with every BVH-based spatial structure, then the spheres with every
+/// integrator on a LinearBVH, and then the camera rays of every scene on a
+/// LinearBVH with and without packet tracing. Reports the build and render
+/// times of each, so that they can be compared on the same machine. The scenes, the cameras
+/// and the samples are fixed, so every structure renders the same image.
+///
+/// Every node of the examples is a single primitive that traverses its own
+/// mesh BVH, so their structures only differ in the top level over 1 and 3
+/// primitives. The cow mesh is read when its node is created and its BVH is
+/// built once, which the build time of the first structure includes.
+int main(int argc, char** argv) {
+    if (argc > 3) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const u64 spp = (argc >= 2) ? std::strtoull(argv[1], nullptr, 10) : 32;
+    if (spp == 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+    const char* cow_path = (argc == 3) ? argv[2] : "examples/obj/cow.obj";
+
+    std::vector<BenchScene> scenes;
+    scenes.push_back(
+        {"Spheres", buildSpheres(), makeCamera(Point3D(0.0, 0.0, -10.0))}
+    );
+    scenes.push_back(
+        {"Cow", buildCow(cow_path), makeCamera(Point3D(0.0, 0.0, -10.0))}
+    );
+    scenes.push_back(
+        {"Hierarchy", buildHierarchy(), makeCamera(Point3D(0.0, 0.0, -3.0))}
+    );
+
+    Config config;
+    config.samplesPerPixel = spp;
+    config.traceDepth = 8;
+
+    println("{} spheres, {} spp", cSpheres, spp);
+
+    for (const BenchScene& scene : scenes) {
+        println("{}:", scene.name);
+        for (const SpatialKind kind : cSpatialKinds) {
+            config.spatialKind = kind;
+            measure(kind, scene.graph, scene.camera, config);
+        }
+    }
+
+    println("Spheres:");
+    config.spatialKind = SpatialKind::LinearBVH;
+    for (const IntegratorKind kind : cIntegratorKinds) {
+        config.integratorKind = kind;
+        measure(kind, scenes.front().graph, scenes.front().camera, config);
+    }
+
+    config.integratorKind = IntegratorKind::Recursive;
+    config.traceDepth = cPrimaryDepth;
+    for (const BenchScene& scene : scenes) {
+        println("{} camera rays:", scene.name);
+        for (const bool packets : {false, true}) {
+            config.packetTracing = packets;
+            measure(
+                packets ? "Packets" : "Single rays",
+                scene.graph,
+                scene.camera,
+                config
+            );
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
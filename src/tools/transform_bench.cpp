@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include "math/transform.hpp"
+#include "util/format.hpp"
+#include "util/pcg.hpp"
+
+namespace {
+
+/// @brief Number of timed runs of each path. The fastest run is reported.
+constexpr Size cRuns = 3;
+
+/// @brief Number of random transforms every ray is moved through.
+constexpr Size cTransforms = 64;
+
+void usage() {
+    eprintln("Usage: TransformBench [ray_count]");
+}
+
+/// @brief Object space hit of a ray, standing in for a surface interaction.
+struct Hit {
+    Point3D p;
+    Normal3D n;
+};
+
+/// @brief Intersects a ray in object space. The hit is the point at t = 1
+/// with the ray direction as its normal, which keeps the cost of the
+/// intersection itself negligible.
+Hit hit(const Ray& ray) {
+    const Vector3D& d = ray.direction;
+    return {ray.at(1.0), Normal3D(d.x, d.y, d.z)};
+}
+
+/// @brief Sums the coordinates of the hit, so that no work is optimized out
+/// and both paths can be checked against each other.
+f64 checksum(const Hit& h) {
+    return h.p.x + h.p.y + h.p.z + h.n.x + h.n.y + h.n.z;
+}
+
+/// @brief Transforms a vector with loops over the full 4x4 matrix, as
+/// Transform did before it read only the affine part.
+Vector3D vectorLoop(const Matrix4D& m, const Vector3D& v) {
+    Vector3D result;
+    for (Index row = 0; row < 3; ++row)
+        for (Index col = 0; col < 3; ++col)
+            result[row] += m(row, col) * v[col];
+    return result;
+}
+
+/// @brief Transforms a point like vectorLoop(), adding the translation.
+Point3D pointLoop(const Matrix4D& m, const Point3D& p) {
+    Point3D result;
+    for (Index row = 0; row < 3; ++row)
+        for (Index col = 0; col < 3; ++col)
+            result[row] += m(row, col) * p[col];
+    result[0] += m(0, 3);
+    result[1] += m(1, 3);
+    result[2] += m(2, 3);
+    return result;
+}
+
+/// @brief Transforms a normal with a transposed copy of the inverse, as
+/// Transform did before it indexed the inverse directly.
+Normal3D normalLoop(const Matrix4D& inverse, const Normal3D& n) {
+    const Matrix4D inv_transpose = transpose(inverse);
+
+    Normal3D result;
+    for (Index row = 0; row < 3; ++row)
+        for (Index col = 0; col < 3; ++col)
+            result[row] += inv_transpose(row, col) * n[col];
+    return result;
+}
+
+/// @brief Round trip of a ray before Primitive cached its inverse transform:
+/// the transform is inverted for every ray, and every transformation loops
+/// over the 4x4 matrix.
+f64 roundTripBaseline(const Transform& object_to_world, const Ray& ray) {
+    const Transform world_to_object = invert(object_to_world);
+    const Ray object_ray(
+        pointLoop(world_to_object.matrix(), ray.origin),
+        vectorLoop(world_to_object.matrix(), ray.direction)
+    );
+
+    Hit h = hit(object_ray);
+    h.p = pointLoop(object_to_world.matrix(), h.p);
+    h.n = normalLoop(object_to_world.inverse(), h.n).normalize();
+    return checksum(h);
+}
+
+/// @brief Round trip of a ray as in Primitive::intersectWorld(), with the
+/// cached inverse transform.
+f64 roundTrip(
+    const Transform& object_to_world,
+    const Transform& world_to_object,
+    const Ray& ray
+) {
+    Hit h = hit(world_to_object(ray));
+    h.p = object_to_world(h.p);
+    h.n = object_to_world(h.n).normalize();
+    return checksum(h);
+}
+
+/// @brief Times the fastest of several runs of the round trip of every ray
+/// through every transform. The sum of the checksums is reported.
+void measure(
+    const char* name, const Size tests, const std::function<f64()>& run
+) {
+    f64 best = 0.0;
+    f64 sum = 0.0;
+    for (Index i = 0; i < cRuns; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        sum = run();
+        const std::chrono::duration<f64> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = (i == 0) ? elapsed.count() : std::min(best, elapsed.count());
+    }
+
+    println(
+        "{}: {} s, {} ns per ray, checksum {}",
+        name,
+        best,
+        best * 1.0e9 / static_cast<f64>(tests),
+        sum
+    );
+}
+
+}
+
+/// @brief Measures the cost per ray of moving a ray into the object space of
+/// a transformed primitive and its hit point and normal back to worldspace,
+/// with the inverse transform cached as in Primitive::intersectWorld(), and
+/// with the inversion per ray and 4x4 loops it replaced. Both paths compute
+/// the same sums, so their checksums agree.
+int main(int argc, char** argv) {
+    if (argc > 2) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const Size ray_count =
+        (argc == 2) ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    if (ray_count == 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    PCG32 rng(1, 0);
+    auto random_vector = [&]() {
+        return Vector3D(
+            rng.uniform<f64>(), rng.uniform<f64>(), rng.uniform<f64>()
+        );
+    };
+
+    std::vector<Transform> transforms;
+    std::vector<Transform> inverses;
+    for (Index i = 0; i < cTransforms; ++i) {
+        const Transform transform =
+            Transform::translate(random_vector() * 10.0) *
+            Transform::rotate(rng.uniform<f64>() * 6.0, random_vector()) *
+            Transform::scale(random_vector() + Vector3D(0.5, 0.5, 0.5));
+        transforms.push_back(transform);
+        inverses.push_back(invert(transform));
+    }
+
+    std::vector<Ray> rays;
+    for (Index i = 0; i < ray_count; ++i) {
+        rays.emplace_back(
+            Point3D(0.0, 0.0, 0.0) + random_vector(),
+            random_vector() - Vector3D(0.5, 0.5, 0.5)
+        );
+    }
+
+    const Size tests = ray_count * cTransforms;
+    println("{} rays x {} transforms", ray_count, cTransforms);
+
+    measure("Cached", tests, [&]() {
+        f64 sum = 0.0;
+        for (const Ray& ray : rays) {
+            for (Index i = 0; i < cTransforms; ++i)
+                sum += roundTrip(transforms[i], inverses[i], ray);
+        }
+        return sum;
+    });
+
+    measure("Baseline", tests, [&]() {
+        f64 sum = 0.0;
+        for (const Ray& ray : rays) {
+            for (const Transform& transform : transforms)
+                sum += roundTripBaseline(transform, ray);
+        }
+        return sum;
+    });
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/math/almost.hpp"
+#include "common/math/constants.hpp"
+#include "common/util/format.hpp"
+#include "common/util/pcg.hpp"
+#include "render/primitive/triangle_kernel.hpp"
+#include "render/primitive/triangle_prim.hpp"
+
+namespace {
+
+/// @brief Number of timed runs of each kernel. The fastest run is reported.
+constexpr Size cRuns = 3;
+
+/// @brief Number of random triangles every ray is tested against.
+constexpr Size cTriangles = 4096;
+
+/// @brief Number of random rays in the verification.
+constexpr Size cVerifyRays = 20000;
+
+/// @brief Every block kernel, supported or not.
+constexpr BlockKernel cKernels[] = {BlockKernel::Scalar, BlockKernel::Avx2};
+
+void usage() {
+    eprintln("Usage: TriangleBench [ray_count] [--verify]");
+}
+
+/// @brief Retrieves the name of the block kernel.
+const char* kernelName(const BlockKernel kernel) {
+    switch (kernel) {
+    case BlockKernel::Scalar:
+        return "scalar";
+    case BlockKernel::Avx2:
+        return "AVX2";
+    }
+    unreachable;
+}
+
+/// @brief Packs the records into blocks, leaving the last block partially
+/// used if the count is not a multiple of the block width.
+std::vector<TriangleBlock> pack(const std::vector<TriangleRecord>& records) {
+    std::vector<TriangleBlock> blocks;
+    for (Index i = 0; i < records.size(); ++i) {
+        if (i % TriangleBlock::WIDTH == 0)
+            blocks.emplace_back();
+        blocks.back().set(i % TriangleBlock::WIDTH, records[i]);
+    }
+    return blocks;
+}
+
+/// @brief TrianglePrim as it was before the watertight kernel, kept as the
+/// baseline. The ray is intersected with the plane of the triangle, and the
+/// hit point is tested with barycentric coordinates in the frame of the two
+/// edges.
+class PlaneTrianglePrim : public Primitive {
+public:
+    PlaneTrianglePrim(const Point3D& Q, const Vector3D& u, const Vector3D& v)
+        : mQ(Q), mU(u), mV(v) {
+        mKind = Kind::Implicit;
+
+        mNormal = Normal3D(mU.cross(mV)).normalize();
+        mD = mNormal.dot(mQ.pos());
+        mBbox = AABB(mQ, mQ + mU).enclosure(AABB(mQ, mQ + mV));
+    }
+
+    Option<SurfaceInteraction> intersect(
+        const Ray& ray, const Interval& bounds
+    ) const override {
+        const Option<f64> hit = hitParameter(ray, bounds);
+        if (!hit)
+            return std::nullopt;
+
+        const f64 t = *hit;
+        const Point3D P = ray.at(t);
+
+        if (ray.direction.dot(mNormal) > 0.0)
+            return SurfaceInteraction(
+                P, -mNormal, SurfaceInteraction::Face::Inside, t
+            );
+        else
+            return SurfaceInteraction(
+                P, mNormal, SurfaceInteraction::Face::Outside, t
+            );
+    }
+
+    bool occluded(const Ray& ray, const Interval& bounds) const override {
+        return hitParameter(ray, bounds).has_value();
+    }
+
+private:
+    Option<f64> hitParameter(const Ray& ray, const Interval& bounds) const {
+        const f64 denom = mNormal.dot(ray.direction);
+
+        // No hit if the ray is parallel to the plane.
+        if (almost::le_zero(math::abs(denom)))
+            return std::nullopt;
+
+        // No hit if the ray parameter is outside the parameter bounds.
+        const f64 t = (mD - mNormal.dot(ray.origin.pos())) / denom;
+        if (!bounds.contains(t))
+            return std::nullopt;
+
+        const Vector3D p = ray.at(t) - mQ;
+
+        // Local frame canonical barycentric coordinate test.
+        const f64 uu = mU.dot(mU);
+        const f64 uv = mU.dot(mV);
+        const f64 vv = mV.dot(mV);
+        const f64 pu = p.dot(mU);
+        const f64 pv = p.dot(mV);
+
+        const f64 denom_bary = uv * uv - uu * vv;
+        const f64 alpha = (uv * pv - vv * pu) / denom_bary;
+        const f64 beta = (uv * pu - uu * pv) / denom_bary;
+
+        // No hit if the ray is outside the plane boundaries.
+        if (almost::l_zero(alpha) || almost::l_zero(beta) ||
+            almost::g(alpha + beta, 1.0))
+            return std::nullopt;
+
+        return t;
+    }
+
+    Point3D mQ;
+    Vector3D mU, mV;
+
+    Normal3D mNormal;
+    f64 mD;
+};
+
+/// @brief Checks every block kernel the CPU supports against TrianglePrim,
+/// which tests one triangle at a time. Blocks are filled with 1 to WIDTH
+/// triangles, some sharing edges, and rays are aimed at random points,
+/// vertices and edge midpoints, with random parameter bounds. Hits must
+/// agree exactly in lane and ray parameter.
+/// @returns Whether every kernel agreed.
+bool verify(PCG32& rng) {
+    auto random_point = [&]() {
+        return Point3D(
+            rng.uniform<f64>(), rng.uniform<f64>(), rng.uniform<f64>()
+        );
+    };
+
+    Size checked = 0;
+    Size hits = 0;
+    Size mismatches = 0;
+
+    for (Index i = 0; i < cVerifyRays; ++i) {
+        // Triangles fan out from a shared vertex, so they share edges.
+        const Size count = 1 + rng.next() % TriangleBlock::WIDTH;
+        const Point3D center = random_point();
+        std::vector<TriangleRecord> records;
+        Point3D previous = random_point();
+        for (Index lane = 0; lane < count; ++lane) {
+            const Point3D next = random_point();
+            records.push_back(TriangleRecord{center, previous, next});
+            previous = next;
+        }
+        const TriangleBlock block = pack(records).front();
+
+        // Aim at a random point, a vertex or an edge midpoint.
+        const TriangleRecord& aim = records[rng.next() % count];
+        Point3D target = random_point();
+        switch (rng.next() % 3) {
+        case 1:
+            target = aim.a;
+            break;
+        case 2:
+            target = aim.a + 0.5 * (aim.b - aim.a);
+            break;
+        }
+
+        const Point3D origin = random_point() + Vector3D(0.0, 0.0, 2.0);
+        const Ray ray(origin, target - origin);
+        const f64 t_min = 0.5 * rng.uniform<f64>();
+        const Interval bounds(t_min, t_min + 2.0 * rng.uniform<f64>());
+
+        Option<BlockHit> expected = std::nullopt;
+        Interval search = bounds;
+        for (Index lane = 0; lane < count; ++lane) {
+            const TriangleRecord& tri = records[lane];
+            const TrianglePrim prim(tri.a, tri.b - tri.a, tri.c - tri.a);
+            if (const Option<SurfaceInteraction> x =
+                    prim.intersect(ray, search)) {
+                search.max = x->t;
+                expected = BlockHit{x->t, lane};
+            }
+        }
+        hits += expected.has_value();
+
+        const TriangleRay triangle_ray(ray);
+        for (const BlockKernel kernel : cKernels) {
+            if (!TriangleRay::supports(kernel))
+                continue;
+
+            const Option<BlockHit> hit =
+                triangle_ray.intersect(block, bounds, kernel);
+            ++checked;
+
+            const bool agrees =
+                hit ? (expected && hit->lane == expected->lane &&
+                       hit->t == expected->t)
+                    : !expected;
+            if (!agrees && mismatches++ < 10)
+                eprintln(
+                    "{} kernel disagrees on ray {}", kernelName(kernel), i
+                );
+        }
+    }
+
+    println(
+        "Verified {} block tests, {} rays hit, {} mismatches",
+        checked,
+        hits,
+        mismatches
+    );
+    return mismatches == 0;
+}
+
+/// @brief Times the fastest of several runs of the kernel, which tests every
+/// ray against every triangle and returns the number of hits.
+void measure(
+    const char* name, const Size tests, const std::function<Size()>& run
+) {
+    f64 best = 0.0;
+    Size hits = 0;
+    for (Index i = 0; i < cRuns; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        hits = run();
+        const std::chrono::duration<f64> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = (i == 0) ? elapsed.count() : std::min(best, elapsed.count());
+    }
+
+    println(
+        "{}: {} s, {} M triangles/s, {} hits",
+        name,
+        best,
+        static_cast<f64>(tests) / 1.0e6 / best,
+        hits
+    );
+}
+
+}
+
+/// @brief Measures the ray-triangle intersection throughput, in triangles
+/// tested per second, of the watertight kernel on precomputed records, of
+/// every supported block kernel, of TrianglePrim and of PlaneTrianglePrim,
+/// the TrianglePrim before the watertight kernel. The last two are
+/// constructed per test as mesh traversal once did. Rays run between random
+/// points of the unit cube, and triangles are small and random within it,
+/// so most tests miss as in BVH leaves. With --verify, the block kernels
+/// are first checked against TrianglePrim.
+int main(int argc, char** argv) {
+    const bool verify_kernels =
+        (argc > 1 && std::strcmp(argv[argc - 1], "--verify") == 0);
+    const int arg_count = verify_kernels ? argc - 1 : argc;
+    if (arg_count > 2) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const Size ray_count =
+        (arg_count == 2) ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    if (ray_count == 0) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    PCG32 rng(1, 0);
+    println("Block kernel = {}", kernelName(TriangleRay::blockKernel()));
+    if (verify_kernels && !verify(rng))
+        return EXIT_FAILURE;
+
+    auto random_point = [&]() {
+        return Point3D(
+            rng.uniform<f64>(), rng.uniform<f64>(), rng.uniform<f64>()
+        );
+    };
+    auto random_offset = [&]() {
+        return Vector3D(
+                   rng.uniform<f64>() - 0.5,
+                   rng.uniform<f64>() - 0.5,
+                   rng.uniform<f64>() - 0.5
+               ) *
+               0.2;
+    };
+
+    std::vector<TriangleRecord> records;
+    for (Index i = 0; i < cTriangles; ++i) {
+        const Point3D a = random_point();
+        records.push_back(
+            TriangleRecord{a, a + random_offset(), a + random_offset()}
+        );
+    }
+
+    std::vector<Ray> rays;
+    for (Index i = 0; i < ray_count; ++i) {
+        const Point3D origin = random_point();
+        rays.emplace_back(origin, random_point() - origin);
+    }
+
+    const Interval bounds(0.0, math::infinity<f64>());
+    const Size tests = ray_count * cTriangles;
+
+    println("{} rays x {} triangles", ray_count, cTriangles);
+
+    measure("TriangleRay", tests, [&]() {
+        Size hits = 0;
+        for (const Ray& ray : rays) {
+            const TriangleRay triangle_ray(ray);
+            for (const TriangleRecord& record : records)
+                hits += triangle_ray.intersect(record, bounds).has_value();
+        }
+        return hits;
+    });
+
+    const std::vector<TriangleBlock> blocks = pack(records);
+    for (const BlockKernel kernel : cKernels) {
+        if (!TriangleRay::supports(kernel))
+            continue;
+
+        const std::string name =
+            formatted("TriangleBlock {}", kernelName(kernel));
+        measure(name.c_str(), tests, [&]() {
+            Size hits = 0;
+            for (const Ray& ray : rays) {
+                const TriangleRay triangle_ray(ray);
+                for (const TriangleBlock& block : blocks)
+                    hits += triangle_ray.intersect(block, bounds, kernel)
+                                .has_value();
+            }
+            return hits;
+        });
+    }
+
+    measure("TrianglePrim", tests, [&]() {
+        Size hits = 0;
+        for (const Ray& ray : rays) {
+            for (const TriangleRecord& record : records) {
+                const TrianglePrim prim(
+                    record.a, record.b - record.a, record.c - record.a
+                );
+                hits += prim.occluded(ray, bounds);
+            }
+        }
+        return hits;
+    });
+
+    measure("PlaneTrianglePrim", tests, [&]() {
+        Size hits = 0;
+        for (const Ray& ray : rays) {
+            for (const TriangleRecord& record : records) {
+                const PlaneTrianglePrim prim(
+                    record.a, record.b - record.a, record.c - record.a
+                );
+                hits += prim.occluded(ray, bounds);
+            }
+        }
+        return hits;
+    });
+
+    return EXIT_SUCCESS;
+}